@@ -0,0 +1,299 @@
+#include <chrono>
+#include <format>
+#include <print>
+#include <string>
+#include <vector>
+#include <limits>
+#include <fstream>
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+
+#include "CompilerInst.h"
+#include "backend/LLVMBackend.h"
+#include "builtins/builtins.h"
+#include "errors/ErrorManager.h"
+#include "lexer/TokenStream.h"
+#include "managers/SourceManager.h"
+#include "modules/Module.h"
+#include "modules/ModuleManager.h"
+#include "utils/FileSystem.h"
+#include "utils/StringPool.h"
+#include "utils/Threadpool.h"
+#include "include/SwirlConfig.h"
+
+namespace fs = std::filesystem;
+
+bool SW_IS_DEBUG = false;
+
+
+namespace {
+/// The shape of the synthetic corpus, along with the benchmark's own settings
+struct BenchOptions {
+    std::size_t modules    = 32;   // length of the import chain, each module imports the previous one
+    std::size_t functions  = 64;   // functions per module
+    std::size_t nesting    = 8;    // depth of the generic type in each function, i.e. `Box!{Box!{...}}`
+    std::size_t array_size = 256;  // elements of the array literal in each function
+    std::size_t iterations = 5;    // each phase reports its fastest run
+
+    fs::path output = "swirl_bench.json";
+};
+
+
+/// The timing of a single phase, the counts are per run
+struct PhaseResult {
+    std::string_view name;
+    double seconds = 0;
+
+    std::size_t bytes  = 0;
+    std::size_t tokens = 0;
+    std::size_t nodes  = 0;
+};
+
+
+void printUsage(const char* exe) {
+    std::println("Usage: {} [--modules N] [--functions N] [--nesting N] [--array-size N] [--iterations N] "
+                 "[--output results.json]", exe);
+}
+
+
+/// Returns false if the arguments are malformed
+bool parseArgs(const int argc, const char** argv, BenchOptions& options) {
+    const std::pair<std::string_view, std::size_t*> numeric_flags[] = {
+        {"--modules", &options.modules}, {"--functions", &options.functions}, {"--nesting", &options.nesting},
+        {"--array-size", &options.array_size}, {"--iterations", &options.iterations}
+    };
+
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg = argv[i];
+        if (i + 1 == argc) return false;
+        const std::string_view value = argv[++i];
+
+        if (arg == "--output") {
+            options.output = value;
+            continue;
+        }
+
+        const auto flag = std::ranges::find(numeric_flags, arg, &std::pair<std::string_view, std::size_t*>::first);
+        if (flag == std::end(numeric_flags)) return false;
+
+        if (const auto [_, ec] = std::from_chars(value.data(), value.data() + value.size(), *flag->second);
+            ec != std::errc{} || *flag->second == 0) return false;
+    } return true;
+}
+
+
+std::string generateModule(const BenchOptions& options, const std::size_t index) {
+    std::string ret;
+    if (index > 0) {
+        ret += std::format("import bench::mod_{};\n\n", index - 1);
+    }
+
+    ret += std::format("export struct Box_{}<T> {{ var value: T; }}\n\n", index);
+
+    std::string nested_type = "i32";
+    for (std::size_t _ = 0; _ < options.nesting; _++) {
+        nested_type = std::format("Box_{}!{{{}}}", index, nested_type);
+    }
+
+    for (std::size_t fn = 0; fn < options.functions; fn++) {
+        ret += std::format("export fn f_{}_{}(a: i32, b: i32): i32 {{\n", index, fn);
+        ret += std::format("    var boxed: {};\n", nested_type);
+
+        ret += "    var values = [";
+        for (std::size_t i = 0; i < options.array_size; i++) {
+            ret += std::format("{}{}", i ? ", " : "", (i * 7 + fn) % 1000);
+        } ret += "];\n";
+
+        ret += std::format("    var x = a * b + {};\n", fn);
+        ret += "    if x > 10 { x = x - 1; } else { x = x + 1; }\n";
+
+        // calls chain the functions of a module, and the modules themselves
+        if (fn > 0) {
+            ret += std::format("    x = x + f_{}_{}(x, b);\n", index, fn - 1);
+        } else if (index > 0) {
+            ret += std::format("    x = x + mod_{}::f_{}_0(a, b);\n", index - 1, index - 1);
+        }
+
+        ret += "    return x;\n}\n\n";
+    } return ret;
+}
+
+
+/// Writes the corpus into a fresh directory, which is registered as the package `bench`
+std::vector<fs::path> writeCorpus(const BenchOptions& options, const fs::path& root) {
+    fs::remove_all(root);
+    fs::create_directories(root);
+
+    std::vector<fs::path> ret;
+    for (std::size_t i = 0; i < options.modules; i++) {
+        ret.push_back(root / std::format("mod_{}.sw", i));
+        std::ofstream(ret.back()) << generateModule(options, i);
+    }
+
+    CompilerInst::PackageTable.erase("bench");
+    CompilerInst::addPackageEntry(root.string() + ":bench", true);
+    return ret;
+}
+
+
+/// A front-end of its own for each run, so that no run benefits from the previous one's state
+struct Pipeline {
+    sw::FileSystem fs;
+    sw::StringPool pool{16 * 1024};
+    ModuleManager  modman;
+    std::size_t    errors = 0;
+
+    Pipeline() {
+        // sema and the backend work against the host, as `swirl` itself does without `--target`
+        if (!CompilerInst::Target.isInitialized())
+            CompilerInst::Target = sw::Target::fromHostTriple();
+
+        const auto Triple = CompilerInst::Target.getTriple();
+        fs.createVirtualFile(SW_BUILTIN_FILE_PATH, SW_BUILTIN_SOURCE);
+    }
+
+    ~Pipeline() {
+        CompilerInst::Target.clearLayouts();
+    }
+
+    ErrorCallback_t errorCallback() {
+        return [this](ErrCode, ErrorContext) { errors++; };
+    }
+
+    Module* insert(const fs::path& path) {
+        return modman.insert({fs.open(path), modman, pool, CompilerInst::Target});
+    }
+
+    std::size_t countNodes() {
+        std::size_t ret = 0;
+        modman.forEachModule([&ret](const Module* module) { ret += module->getNodeCount(); });
+        return ret;
+    }
+};
+
+
+template <typename Fn>
+double measure(Fn fn) {
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+/// Runs every phase `options.iterations` times, keeps the fastest run of each
+std::vector<PhaseResult> runPhases(const BenchOptions& options, const std::vector<fs::path>& files) {
+    PhaseResult lex{"lex"}, parse{"parse"}, sema{"sema"}, irgen{"irgen"};
+    lex.seconds = parse.seconds = sema.seconds = irgen.seconds = std::numeric_limits<double>::max();
+
+    for (std::size_t _ = 0; _ < options.iterations; _++) {
+        // lexing alone, with the files already in memory
+        {
+            Pipeline pipeline;
+            std::vector<Module*> modules;
+            std::size_t bytes = 0;
+            for (const auto& path : files) {
+                modules.push_back(pipeline.insert(path));
+                bytes += modules.back()->file_handle->readAll().size();
+            }
+
+            std::size_t tokens = 0;
+            lex.seconds = std::min(lex.seconds, measure([&] {
+                for (Module* module : modules) {
+                    SourceManager src_man(module);
+                    TokenStream stream(src_man, pipeline.pool);
+                    while (stream.next().type != NONE) tokens++;
+                }
+            }));
+            lex.bytes  = bytes;
+            lex.tokens = tokens;
+        }
+
+        // the main module pulls in the rest through the chain of imports, the pool has no threads so
+        // everything runs on this thread
+        Pipeline pipeline;
+        Module* main_module = pipeline.insert(files.back());
+
+        parse.seconds = std::min(parse.seconds, measure([&] {
+            main_module->parse(pipeline.errorCallback());
+        }));
+        parse.nodes = pipeline.countNodes();
+
+        sw::ThreadPool thread_pool;
+        sema.seconds = std::min(sema.seconds, measure([&] {
+            pipeline.modman.scheduleDependenciesFirst(thread_pool, [&pipeline](Module* module) {
+                module->performSema(pipeline.errorCallback());
+            });
+        }));
+        sema.nodes = pipeline.countNodes();
+
+        std::vector<std::unique_ptr<LLVMBackend>> backends;
+        irgen.seconds = std::min(irgen.seconds, measure([&] {
+            for (Module* module : pipeline.modman) {
+                backends.push_back(std::make_unique<LLVMBackend>(module));
+                backends.back()->dispatch(module->ast);
+            }
+        }));
+        irgen.nodes = sema.nodes;
+
+        if (pipeline.errors) {
+            std::println(stderr, "warning: the corpus produced {} error(s), the figures are skewed", pipeline.errors);
+        }
+    }
+
+    parse.bytes = sema.bytes = irgen.bytes = lex.bytes;
+    parse.tokens = sema.tokens = irgen.tokens = lex.tokens;
+    return {lex, parse, sema, irgen};
+}
+
+
+std::string toJSON(const BenchOptions& options, const std::vector<PhaseResult>& results) {
+    const auto timestamp = std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::now());
+
+    std::string ret = "{\n";
+    ret += std::format("  \"version\": \"{}.{}.{}\",\n", VERSION_MAJOR, VERSION_MINOR, VERSION_PATCH);
+    ret += std::format("  \"timestamp\": \"{:%FT%TZ}\",\n", timestamp);
+    ret += std::format("  \"iterations\": {},\n", options.iterations);
+    ret += std::format(
+        "  \"corpus\": {{\"modules\": {}, \"functions_per_module\": {}, \"generic_nesting\": {}, "
+        "\"array_size\": {}, \"bytes\": {}, \"tokens\": {}}},\n",
+        options.modules, options.functions, options.nesting, options.array_size,
+        results.front().bytes, results.front().tokens);
+
+    ret += "  \"phases\": {\n";
+    for (std::size_t i = 0; i < results.size(); i++) {
+        const auto& result = results[i];
+        ret += std::format(
+            "    \"{}\": {{\"seconds\": {:.6f}, \"mb_per_s\": {:.3f}, \"tokens_per_s\": {:.0f}, \"nodes\": {}, "
+            "\"nodes_per_s\": {:.0f}}}{}\n",
+            result.name, result.seconds, result.bytes / result.seconds / 1e6, result.tokens / result.seconds,
+            result.nodes, result.nodes / result.seconds, i + 1 == results.size() ? "" : ",");
+    }
+
+    ret += "  }\n}\n";
+    return ret;
+}
+}
+
+
+int main(const int argc, const char** argv) {
+    BenchOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    const auto root  = fs::temp_directory_path() / "swirl_bench_corpus";
+    const auto files = writeCorpus(options, root);
+    const auto results = runPhases(options, files);
+    fs::remove_all(root);
+
+    for (const auto& result : results) {
+        std::println("{:<6} {:>10.3f} ms {:>10.2f} MB/s {:>12.0f} tokens/s {:>12.0f} nodes/s",
+            result.name, result.seconds * 1e3, result.bytes / result.seconds / 1e6,
+            result.tokens / result.seconds, result.nodes / result.seconds);
+    }
+
+    std::ofstream(options.output) << toJSON(options, results);
+    std::println("Results written to {}", fs::absolute(options.output).string());
+}
@@ -1,16 +1,20 @@
 #pragma once
+#include <ranges>
 #include <utility>
 #include <filesystem>
 #include <unordered_set>
 
 #include "Target.h"
 #include "utils/Threadpool.h"
+#include "utils/Parallelism.h"
 #include "utils/logging.h"
 #include "backend/LLVMBackend.h"
 #include "errors/ErrorPipeline.h"
 #include "modules/ModuleManager.h"
+#include "managers/BuildManifest.h"
 #include "utils/FileSystem.h"
 #include "utils/StringPool.h"
+#include "utils/TimeTrace.h"
 #include "builtins/builtins.h"
 
 
@@ -26,7 +30,11 @@ class CompilerInst {
     ModuleManager  m_ModuleManager;
 
     fs::path       m_SrcPath;
-    unsigned       m_BaseThreadCount = std::thread::hardware_concurrency() / 2;
+    std::optional<unsigned> m_BaseThreadCount;
+    sw::StageParallelism    m_StageThreads;
+
+    BuildManifest  m_BuildManifest;
+    std::unordered_map<Module*, BuildManifest::Entry> m_Fingerprints;
 
     sw::FileSystem m_Filesystem;
     sw::StringPool m_StringPool;
@@ -44,32 +52,57 @@ class CompilerInst {
     /// generates object files for all the modules
     void generateObjectFiles(Backends_t&);
 
+    /// fingerprints all the modules and marks the ones whose object files can be reused
+    void computeFingerprints();
+
+    /// returns the path to the object file of `module`, derived from its UID
+    fs::path getObjectPath(Module* module) const;
+
+    /// prints the memory held by the allocators, the string pool and the tables of each module
+    void printMemoryReport();
+
     struct PackageInfo;
     friend struct Module;
 
 public:
+    /// The optimization levels which can be requested through `-O`
+    enum class OptLevel { O0, O1, O2, O3, Os };
+
     inline static int RecursionDepth = 1024;
+    inline static OptLevel OptimizationLevel = OptLevel::O0;
     inline static sw::Target  Target;
     inline static std::unordered_set<std::string> LinkTargets;
     inline static std::unordered_map<std::string, PackageInfo> PackageTable;
     inline static fs::path OutputPath; // path/to/executable (absolute)
 
     inline static bool RunExe = false;
+    inline static bool PreTokenize = false;  // lex each file in full before parsing it
+    inline static bool TimeReport  = false;  // time each phase, see `sw::TimeTrace`
+    inline static bool MemReport   = false;  // report the memory usage after the build
 
     explicit CompilerInst(fs::path path)
         : m_SrcPath(std::move(path))
+        , m_BuildManifest(m_SrcPath.parent_path() / ".build" / "manifest")
         , m_StringPool(16 * 1024)
     {
         m_ErrorCallback = [this](const ErrCode code, const ErrorContext& ctx) {
             m_ErrorManager.newErrorLocked(code, ctx);
         };
+
+        m_ModuleManager.setThreadPool(&m_ThreadPool);
+    }
+
+    /// The cached layouts are keyed by the addresses of this compilation's types, which a later one may reuse
+    ~CompilerInst() {
+        Target.clearLayouts();
     }
 
 
+    /// Overrides the no. of threads the pool is sized with, `0` runs every task on the main thread
     void setBaseThreadCount(const std::string& count) {
         m_BaseThreadCount = static_cast<unsigned>(std::stoi(count));
-        if (m_BaseThreadCount) {
-            m_ThreadPool.setBaseThreadCount(m_BaseThreadCount);
+        if (*m_BaseThreadCount) {
+            m_ThreadPool.setBaseThreadCount(*m_BaseThreadCount);
         }
     }
 
@@ -89,14 +122,32 @@ public:
         Target = sw::Target::fromTriple(triple);
     }
 
+    /// Parses the value of the `-O` flag (one of `0`, `1`, `2`, `3` or `s`)
+    static void setOptimizationLevel(std::string_view level);
+
 
     void compile() {
+        if (TimeReport) {
+            sw::TimeTrace::enable();
+        }
+
         if (!Target.isInitialized()) {
             Target = sw::Target::fromHostTriple();
         }
 
         const auto Triple = Target.getTriple();
 
+        // unless `-j` was passed, size the pool after the CPUs which are actually available to the process,
+        // leaving one for the main thread, which runs tasks too while it waits on the pool
+        if (!m_BaseThreadCount) {
+            m_BaseThreadCount = std::max(1u, sw::getAvailableParallelism() - 1);
+            m_ThreadPool.setBaseThreadCount(*m_BaseThreadCount);
+        }
+
+        m_StageThreads = sw::StageParallelism::fromThreadCount(*m_BaseThreadCount);
+        SW_LOG_INFO("Threads: {} (frontend: {}, emit: {})", *m_BaseThreadCount, m_StageThreads.frontend,
+            m_StageThreads.emit);
+
         // create a virtual file for builtins
         m_Filesystem.createVirtualFile(SW_BUILTIN_FILE_PATH, SW_BUILTIN_SOURCE);
 
@@ -113,29 +164,30 @@ public:
 
         // add an entry to the module manager
         m_ModuleManager.insert(file_handle, main_module);
+        m_ModuleManager.setPretokenize(PreTokenize);
+        m_ThreadPool.setActiveThreadCount(m_StageThreads.frontend);
         main_module->parse(m_ErrorCallback);
 
+        // the imported modules are parsed on the thread pool as they get discovered
+        m_ThreadPool.wait();
+
         // check for parser errors and flush if present
         if (m_ErrorManager.errorOccurred()) {
             m_ErrorManager.flush();
         }
 
+        // find the modules which can reuse their object files from the previous build
+        computeFingerprints();
+
         // || --- *---*   Sema   *---* --- || //
-        int batch_no = 1;
-        while (!m_ModuleManager.zeroVecIsEmpty()) {
-            SW_LOG_INFO("Batch-{}: ", batch_no);
-            batch_no++;
-            while (const auto mod = m_ModuleManager.popZeroDepVec()) {
-                SW_LOG_INFO("{}, ", mod->file_handle->getPath().string());
-
-                m_ThreadPool.enqueue([this, mod] {
-                    mod->performSema(m_ErrorCallback);
-                });
+        m_ModuleManager.scheduleDependenciesFirst(m_ThreadPool, [this](Module* mod) {
+            if (!mod->requires_sema) {
+                return;
             }
 
-            m_ModuleManager.swapBuffers();
-            m_ThreadPool.wait();
-        } m_ThreadPool.wait();
+            SW_LOG_INFO("Sema: {}", mod->file_handle->getPath().string());
+            mod->performSema(m_ErrorCallback);
+        });
 
         // *---* - *---*  *---* - *---*  *---* - *---* //
         // check for Sema errors and abort if present
@@ -145,6 +197,14 @@ public:
 
         startLLVMCodegen();
         m_ErrorManager.m_OutputPipeline = nullptr;  // just to be safe
+
+        if (MemReport) {
+            printMemoryReport();
+        }
+
+        for (const auto& [i, stats] : std::views::enumerate(m_ThreadPool.getWorkerStats())) {
+            SW_LOG_INFO("Worker-{}: {} tasks, {:.1f}% busy", i, stats.tasks_run, stats.utilization() * 100);
+        }
     }
 
     /// Parses the string and adds an entry to the package table
@@ -1,7 +1,11 @@
 #pragma once
 #include <algorithm>
 #include <string>
+#include <vector>
+#include <memory>
 #include <stdexcept>
+#include <shared_mutex>
+#include <unordered_map>
 
 #include "types/SwTypes.h"
 
@@ -233,6 +237,14 @@ public:
     }
 
 
+    /// The layout of an aggregate (a struct or an array), matching the one of the backend's `DataLayout`
+    struct Layout {
+        std::size_t size_bits = 0;
+        std::size_t align     = 1;          // in bytes
+        std::vector<std::size_t> field_offsets;  // of a struct's fields, in bytes
+    };
+
+
     [[nodiscard]]
     const Triple_t& getTriple() const { return m_Triple; }
 
@@ -274,15 +286,12 @@ public:
                 return 8;  // { ptr, i64 } — 8-byte aligned due to i64
 
             case Type::ARRAY:
-                return getAlignment(type->to<ArrayType>()->of_type);
-            case Type::ENUM:
-                return getAlignment(type->to<EnumType>()->of_type);
             case Type::STRUCT: {
-                std::size_t maxAlign = 1;
-                for (auto* field : type->to<StructType>()->field_types)
-                    maxAlign = std::max(maxAlign, getAlignment(field));
-                return maxAlign;
+                Layout scratch;
+                return getLayout(type, scratch).align;
             }
+            case Type::ENUM:
+                return getAlignment(type->to<EnumType>()->of_type);
 
             // ---- C types ----
 
@@ -368,17 +377,15 @@ public:
                 return ((ptrBits + 63) & ~std::size_t{63}) + 64;
             }
 
-            case Type::ARRAY: {
-                auto* arr = type->to<ArrayType>();
-                return getSizeInBits(arr->of_type) * arr->size;
+            case Type::ARRAY:
+            case Type::STRUCT: {
+                Layout scratch;
+                return getLayout(type, scratch).size_bits;
             }
 
             case Type::ENUM:
                 return getSizeInBits(type->to<EnumType>()->of_type);
 
-            case Type::STRUCT:
-                return computeStructSizeBits(type->to<StructType>());
-
             // ---- C types  ----
 
             case Type::C_CHAR:
@@ -428,6 +435,50 @@ public:
     }
 
 
+    /// The size of `type` including its tail padding, i.e. its stride within an array, in bytes
+    std::size_t getAllocSize(Type* type) const {
+        return alignTo((getSizeInBits(type) + 7) / 8, getAlignment(type));
+    }
+
+
+    /// Returns the offset of the struct's `index`th field in bytes
+    std::size_t getFieldOffset(StructType* type, const std::size_t index) const {
+        Layout scratch;
+        return getLayout(type, scratch).field_offsets.at(index);
+    }
+
+
+    /// Returns the layout of a struct or an array, which is computed once and then cached, thread-safe. The
+    /// layout of a struct whose fields are yet to be resolved, or of an aggregate containing one, is computed
+    /// into `scratch` on each query instead, as sema may ask for it from within the struct itself.
+    const Layout& getLayout(Type* type, Layout& scratch) const {
+        {
+            std::shared_lock lock(m_Layouts->mutex);
+            if (const auto it = m_Layouts->table.find(type); it != m_Layouts->table.end())
+                return *it->second;
+        }
+
+        if (!isLayoutFinal(type)) {
+            scratch = computeLayout(type);
+            return scratch;
+        }
+
+        // computed without the lock held, as the layouts of the members are looked up on the way
+        auto layout = std::make_unique<Layout>(computeLayout(type));
+
+        std::unique_lock lock(m_Layouts->mutex);
+        return *m_Layouts->table.try_emplace(type, std::move(layout)).first->second;
+    }
+
+
+    /// Drops the cached layouts, which are keyed by the types of a compilation and go stale once its modules are
+    /// destroyed, to be called once the compilation is over. The references `getLayout` handed out are invalidated.
+    void clearLayouts() {
+        std::unique_lock lock(m_Layouts->mutex);
+        m_Layouts->table.clear();
+    }
+
+
     [[nodiscard]]  /// Returns pointer size for the target in bytes
     std::size_t getPointerSize() const {
         switch (m_Triple.getArch()) {
@@ -441,9 +492,21 @@ public:
 
 
 private:
+    struct LayoutCache {
+        std::shared_mutex mutex;
+        std::unordered_map<Type*, std::unique_ptr<Layout>> table;
+    };
+
     Triple_t m_Triple;
     bool     m_Initialized = false;
 
+    std::unique_ptr<LayoutCache> m_Layouts = std::make_unique<LayoutCache>();
+
+
+    static std::size_t alignTo(const std::size_t value, const std::size_t align) {
+        return (value + align - 1) & ~(align - 1);
+    }
+
 
     [[nodiscard]]
     std::size_t getLDoubleAlignment() const {
@@ -487,17 +550,50 @@ private:
     }
 
 
-    std::size_t computeStructSizeBits(StructType* st) const {
-        std::size_t sizeBits = 0;
+    /// Whether the layout of `type` can no longer change, i.e. the structs it contains by value are complete
+    static bool isLayoutFinal(Type* type) {
+        switch (type->kind) {
+            case Type::ARRAY:
+                return isLayoutFinal(type->to<ArrayType>()->of_type);
+            case Type::STRUCT: {
+                const auto* st = type->to<StructType>();
+                return st->is_complete && std::ranges::all_of(st->field_types, &isLayoutFinal);
+            }
+            default:
+                return true;
+        }
+    }
+
 
+    /// Lays out the type as LLVM does: each field is placed at the next multiple of its alignment and
+    /// takes up its alloc-size, and so does each element of an array
+    Layout computeLayout(Type* type) const {
+        Layout ret;
+
+        if (type->kind == Type::ARRAY) {
+            const auto* arr = type->to<ArrayType>();
+            ret.align     = getAlignment(arr->of_type);
+            ret.size_bits = getAllocSize(arr->of_type) * arr->size * 8;
+            return ret;
+        }
+
+        const auto* st = type->to<StructType>();
+        ret.field_offsets.reserve(st->field_types.size());
+
+        std::size_t offset = 0;
         for (auto* field : st->field_types) {
-            const std::size_t fieldAlignBits = getAlignment(field) * 8;
-            sizeBits = (sizeBits + fieldAlignBits - 1) & ~(fieldAlignBits - 1);
-            sizeBits += getSizeInBits(field);
+            const std::size_t align = getAlignment(field);
+            offset = alignTo(offset, align);
+            ret.field_offsets.push_back(offset);
+            offset += getAllocSize(field);
+            ret.align = std::max(ret.align, align);
         }
 
-        const std::size_t structAlignBits = getAlignment(st) * 8;
-        return (sizeBits + structAlignBits - 1) & ~(structAlignBits - 1);
+        // an empty struct is lowered to `{ i8 }`
+        if (st->field_types.empty()) offset = 1;
+
+        ret.size_bits = alignTo(offset, ret.align) * 8;
+        return ret;
     }
 };
 }
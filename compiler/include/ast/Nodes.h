@@ -1,6 +1,7 @@
 #pragma once
 #include <string_view>
 #include <filesystem>
+#include <algorithm>
 #include <stdexcept>
 #include <utility>
 #include <variant>
@@ -59,6 +60,13 @@ enum NodeType {
 };
 #undef SW_NODE
 
+#define SW_NODE(x, y) #y,
+/// The class name of each `NodeType`, indexed by it
+inline constexpr std::string_view NodeTypeNames[] = { SW_NODE_LIST };
+#undef SW_NODE
+
+inline constexpr std::size_t NodeTypeCount = std::size(NodeTypeNames);
+
 
 struct Node;
 struct Var;
@@ -72,7 +80,8 @@ class IdentInfo;
 class LLVMBackend;
 
 
-// The common base class of all the nodes
+/// The common base class of all the nodes. Nodes have no vtable, the accessors switch over `kind`
+/// (see the end of this file) and each node type provides a `classof` for `isa`, `cast` and `dyn_cast`.
 struct Node {
     SourceLocation location;
     NodeType kind = ND_INVALID;
@@ -81,52 +90,35 @@ struct Node {
     explicit Node(const NodeType ty)
         : kind(ty) {}
 
-    virtual ~Node() = default;
-
     /// Returns a tag which identifies the node's kind
-    [[nodiscard]] virtual NodeType getNodeType() const {
+    [[nodiscard]] NodeType getNodeType() const {
         return kind;
     }
 
     /// Is the node allowed to appear in global context (E.g. Functions, Vars)?
-    [[nodiscard]] virtual bool isGlobal() const {
-        return false;
-    }
+    [[nodiscard]] bool isGlobal() const;
 
     /// Is the node representing a literal?
-    [[nodiscard]] virtual bool isLiteral() const {
-        return false;
-    }
+    [[nodiscard]] bool isLiteral() const;
 
     /// Fetches the `IdentInfo*` that a node is holding, if any
-    virtual IdentInfo* getIdentInfo() {
-        throw std::runtime_error("getIdentInfo called on Node instance");
-    }
+    IdentInfo* getIdentInfo();
 
     /// Convenient method to fetch the wrapped-node from an expression
-    virtual Node* getExprValue() {
-        throw std::runtime_error("getExprValue called on Node instance");
-    }
+    Node* getExprValue();
 
     /// Returns the wrapped-node if the node is a wrapper, returns the instance itself otherwise
-    virtual Node* getWrappedNodeOrInstance() {
-        return this;
-    }
+    Node* getWrappedNodeOrInstance();
 
-    [[nodiscard]] virtual Ident* getIdent() {
-        return nullptr;
-    }
+    [[nodiscard]] Ident* getIdent();
 
-    virtual Type* getSwType() {
-        throw std::runtime_error("getSwType: unimplemented!");
-    }
+    Type* getSwType();
 
-    template <typename From>
-    std::add_pointer_t<From> to() {
-        return dynamic_cast<std::add_pointer_t<From>>(this);
-    }
+    static bool classof(const Node*) { return true; }
 };
 
+static_assert(!std::is_polymorphic_v<Node>, "nodes must not carry a vtable");
+
 
 struct GenericParam final : Node {
     std::string_view  name;
@@ -136,10 +128,7 @@ struct GenericParam final : Node {
     explicit
     GenericParam() : Node(ND_GENERIC_PARAM), id(nullptr) {}
 
-    [[nodiscard]]
-    NodeType getNodeType() const override {
-        return ND_GENERIC_PARAM;
-    }
+    static bool classof(const Node* node) { return node->kind == ND_GENERIC_PARAM; }
 };
 
 
@@ -157,9 +146,14 @@ struct GlobalNode : Node {
     explicit GlobalNode(const NodeType ty)
         : Node(ty) {}
 
-    [[nodiscard]]
-    bool isGlobal() const override {
-        return true;
+    static bool classof(const Node* node) {
+        switch (node->kind) {
+            case ND_VAR: case ND_FUNC: case ND_IMPORT: case ND_ENUM:
+            case ND_PROTOCOL: case ND_PROTOCOL_IMPL: case ND_STRUCT:
+                return true;
+            default:
+                return false;
+        }
     }
 };
 
@@ -182,29 +176,11 @@ struct Expression final : Node {
     // set the type of sub-expression instances to `to`
     void setType(Type* to);
 
-    IdentInfo* getIdentInfo() override {
-        return expr->getIdentInfo();
-    }
-
-    [[nodiscard]] Node* getExprValue() override {
-        return expr;
-    }
-
-    [[nodiscard]] NodeType getNodeType() const override {
-        return ND_EXPR;
-    }
-
-    Node* getWrappedNodeOrInstance() override {
-        return expr->getWrappedNodeOrInstance();
-    }
+    static bool classof(const Node* node) { return node->kind == ND_EXPR; }
 
     bool operator==(const Expression& other) const {
         return this->expr == other.expr && this->expr_type == other.expr_type;
     }
-
-    Type* getSwType() override {
-        return expr_type;
-    }
 };
 
 
@@ -286,9 +262,7 @@ struct Op final : Node {
     // set the type of sub-expression instances to `to`
     void setType(Type* to) const;
 
-    [[nodiscard]]
-    NodeType getNodeType() const override { return ND_OP; }
-    Type* getSwType() override { return common_type; }
+    static bool classof(const Node* node) { return node->kind == ND_OP; }
 
     [[nodiscard]] Node* getLHS() const {
         assert(!operands.empty());
@@ -314,14 +288,14 @@ struct ReturnStatement final : Node {
     ReturnStatement()
         : Node(ND_RET) {}
 
-    [[nodiscard]] NodeType getNodeType() const override {
-        return ND_RET;
-    }
+    static bool classof(const Node* node) { return node->kind == ND_RET; }
 };
 
 
 struct UndefinedValue final : Node {
     explicit UndefinedValue() : Node(ND_UNDEFINED) {}
+
+    static bool classof(const Node* node) { return node->kind == ND_UNDEFINED; }
 };
 
 
@@ -331,14 +305,7 @@ struct IntLit final : Node {
     explicit IntLit(const std::string_view val)
         : Node(ND_INT), value(val) {}
 
-
-    [[nodiscard]] NodeType getNodeType() const override {
-        return ND_INT;
-    }
-
-    [[nodiscard]] bool isLiteral() const override {
-        return true;
-    }
+    static bool classof(const Node* node) { return node->kind == ND_INT; }
 };
 
 
@@ -348,13 +315,7 @@ struct FloatLit final : Node {
     explicit FloatLit(const std::string_view val)
         : Node(ND_FLOAT), value(val) {}
 
-    [[nodiscard]] NodeType getNodeType() const override {
-        return ND_FLOAT;
-    }
-
-    [[nodiscard]] bool isLiteral() const override {
-        return true;
-    }
+    static bool classof(const Node* node) { return node->kind == ND_FLOAT; }
 };
 
 
@@ -364,13 +325,7 @@ struct BoolLit final : Node {
     explicit BoolLit(const bool is_true)
         : Node(ND_BOOL), value(is_true) {}
 
-    [[nodiscard]] NodeType getNodeType() const override {
-        return ND_BOOL;
-    }
-
-    [[nodiscard]] bool isLiteral() const override {
-        return true;
-    }
+    static bool classof(const Node* node) { return node->kind == ND_BOOL; }
 };
 
 
@@ -379,6 +334,8 @@ struct CharLit final : Node {
     explicit CharLit(const char val)
         : Node(ND_CHAR)
         , value(val) {}
+
+    static bool classof(const Node* node) { return node->kind == ND_CHAR; }
 };
 
 
@@ -388,15 +345,7 @@ struct StrLit final : Node {
     explicit StrLit(const std::string_view val)
         : Node(ND_STR), value(val) {}
 
-    [[nodiscard]]
-    NodeType getNodeType() const override {
-        return ND_STR;
-    }
-
-    [[nodiscard]]
-    bool isLiteral() const override {
-        return true;
-    }
+    static bool classof(const Node* node) { return node->kind == ND_STR; }
 };
 
 
@@ -414,6 +363,8 @@ struct GenericArgList final : Node {
     [[nodiscard]] bool empty()   const { return generic_args.empty(); }
 
     [[nodiscard]] auto at(const std::size_t i) const { return generic_args.at(i); }
+
+    static bool classof(const Node* node) { return node->kind == ND_GEN_ARG_LIST; }
 };
 
 
@@ -428,8 +379,6 @@ struct Ident final : Node {
     IdentInfo* value = nullptr;
     std::span<Qualifier> full_qualification;
 
-    // to keep pre-computed generic instantiation steps to avoid repetitive looping
-    std::unordered_map<Type*, Type*> type_instantiation_map;
 
     explicit Ident()
         : Node(ND_IDENT) {}
@@ -440,20 +389,9 @@ struct Ident final : Node {
     /// Convenience constructor for the creation of temporary objects, not to be used for
     /// the construction of AST nodes
     explicit Ident(const std::span<Qualifier> full_qualification)
-        : full_qualification(full_qualification) {}
+        : Node(ND_IDENT), full_qualification(full_qualification) {}
 
-
-    IdentInfo* getIdentInfo() override {
-        return value;
-    }
-
-    [[nodiscard]] NodeType getNodeType() const override {
-        return ND_IDENT;
-    }
-
-    [[nodiscard]] Ident* getIdent() override {
-        return this;
-    }
+    static bool classof(const Node* node) { return node->kind == ND_IDENT; }
 
     [[nodiscard]]
     std::string toString() const {
@@ -490,15 +428,7 @@ struct TypeWrapper final : Node {
     explicit TypeWrapper(Type* ty)
         : Node(ND_TYPE), type(ty) {}
 
-    [[nodiscard]]
-    Type* getSwType() override {
-        return type;
-    }
-
-    [[nodiscard]]
-    NodeType getNodeType() const override {
-        return ND_TYPE;
-    }
+    static bool classof(const Node* node) { return node->kind == ND_TYPE; }
 };
 
 
@@ -511,7 +441,7 @@ struct TypeAlias final : Node {
     TypeAlias()
         : Node(ND_TYPE_ALIAS) {}
 
-    [[nodiscard]] NodeType getNodeType() const override { return ND_TYPE_ALIAS; }
+    static bool classof(const Node* node) { return node->kind == ND_TYPE_ALIAS; }
 };
 
 
@@ -548,6 +478,8 @@ struct GenericArg final : Node {
         return std::get<TypeWrapper*>(value);
     }
 
+    static bool classof(const Node* node) { return node->kind == ND_GEN_ARG; }
+
 
 private:
     std::variant<std::monostate, Expression*, TypeWrapper*> value;
@@ -567,13 +499,7 @@ struct Var final : GlobalNode {
 
     explicit Var(): GlobalNode(ND_VAR) {}
 
-    [[nodiscard]] NodeType getNodeType()  const override { return ND_VAR; }
-
-    IdentInfo* getIdentInfo() override {
-        return var_ident;
-    }
-
-    [[nodiscard]] Node* getExprValue() override { return value->expr; }
+    static bool classof(const Node* node) { return node->kind == ND_VAR; }
 };
 
 
@@ -586,9 +512,7 @@ struct Scope final : Node {
     explicit Scope()
         : Node(ND_SCOPE) {}
 
-    [[nodiscard]] NodeType getNodeType() const override {
-        return ND_SCOPE;
-    }
+    static bool classof(const Node* node) { return node->kind == ND_SCOPE; }
 };
 
 
@@ -606,6 +530,8 @@ struct Parameter final : Node {
 
     Parameter()
         : Node(ND_PARAM) {}
+
+    static bool classof(const Node* node) { return node->kind == ND_PARAM; }
 };
 
 
@@ -621,13 +547,7 @@ struct Function final : GlobalNode {
     explicit Function()
         : GlobalNode(ND_FUNC) {}
 
-    IdentInfo* getIdentInfo() override {
-        return ident;
-    }
-
-    [[nodiscard]] NodeType getNodeType() const override {
-        return ND_FUNC;
-    }
+    static bool classof(const Node* node) { return node->kind == ND_FUNC; }
 };
 
 
@@ -641,19 +561,7 @@ struct FuncCall final : Node {
     explicit FuncCall()
         : Node(ND_CALL) {}
 
-    IdentInfo* getIdentInfo() override {
-        return ident->getIdentInfo();
-    }
-
-    Type* getSwType() override {
-        return signature;
-    }
-
-    [[nodiscard]] Ident* getIdent() override {
-        return ident;
-    }
-
-    [[nodiscard]] NodeType getNodeType() const override { return ND_CALL; }
+    static bool classof(const Node* node) { return node->kind == ND_CALL; }
 };
 
 
@@ -680,7 +588,7 @@ struct Intrinsic final : Node {
         }; intrinsic_type = tag_map.at(ident->full_qualification.at(0).name);
     }
 
-    [[nodiscard]] NodeType getNodeType() const override { return ND_INTRINSIC; }
+    static bool classof(const Node* node) { return node->kind == ND_INTRINSIC; }
 };
 
 
@@ -699,9 +607,7 @@ struct ImportNode final : GlobalNode {
     explicit ImportNode()
         : GlobalNode(ND_IMPORT) {}
 
-    [[nodiscard]] NodeType getNodeType() const override {
-        return ND_IMPORT;
-    }
+    static bool classof(const Node* node) { return node->kind == ND_IMPORT; }
 };
 
 
@@ -712,14 +618,7 @@ struct ArrayLit final : Node {
     explicit ArrayLit()
         : Node(ND_ARRAY) {}
 
-    Type* getSwType() override {
-        return type;
-    }
-
-    [[nodiscard]]
-    bool isLiteral() const override {
-        return true;
-    }
+    static bool classof(const Node* node) { return node->kind == ND_ARRAY; }
 };
 
 
@@ -730,40 +629,49 @@ struct WhileLoop final : Node {
     explicit WhileLoop()
         : Node(ND_WHILE) {}
 
-    [[nodiscard]] NodeType getNodeType() const override {
-        return ND_WHILE;
-    }
+    static bool classof(const Node* node) { return node->kind == ND_WHILE; }
 };
 
 
 struct BreakStmt final : Node {
     explicit BreakStmt(): Node(ND_BREAK) {}
 
-    [[nodiscard]] NodeType getNodeType() const override { return ND_BREAK;}
+    static bool classof(const Node* node) { return node->kind == ND_BREAK; }
 };
 
 
 struct ContinueStmt final : Node {
     explicit ContinueStmt(): Node(ND_CONTINUE) {}
 
-    [[nodiscard]] NodeType getNodeType() const override { return ND_CONTINUE; }
+    static bool classof(const Node* node) { return node->kind == ND_CONTINUE; }
 };
 
 
 struct Enum final : GlobalNode {
+    struct Entry {
+        std::string_view name;
+        int value;
+    };
+
     IdentInfo* ident;
 
     std::optional<TypeWrapper*> enum_type;
-    std::unordered_map<std::string_view, int> entries;
+    std::span<Entry> entries;         // in the order of declaration
+    std::span<Entry> sorted_entries;  // by name, for `getValueOf`
 
     explicit Enum()
         : GlobalNode(ND_ENUM)
         , ident(nullptr) {}
 
-    int counter = 0;
-    void addEntry(const std::string_view id) {
-        entries.emplace(id, counter++);
+    /// Returns the value of the entry `name`, which must exist
+    [[nodiscard]] int getValueOf(const std::string_view name) const {
+        const auto entry = std::ranges::lower_bound(sorted_entries, name, {}, &Entry::name);
+        if (entry != sorted_entries.end() && entry->name == name)
+            return entry->value;
+        throw std::runtime_error(std::format("Enum::getValueOf: no entry named `{}`", name));
     }
+
+    static bool classof(const Node* node) { return node->kind == ND_ENUM; }
 };
 
 
@@ -825,15 +733,10 @@ struct Protocol final : GlobalNode {
     std::span<MethodSignature<>> methods;
     std::span<TypeAlias*> type_aliases;
 
-    IdentInfo* getIdentInfo() override {
-        return ident;
-    }
-
     explicit Protocol()
         : GlobalNode(ND_PROTOCOL) {}
 
-    [[nodiscard]]
-    NodeType getNodeType() const override { return ND_PROTOCOL; }
+    static bool classof(const Node* node) { return node->kind == ND_PROTOCOL; }
 };
 
 
@@ -888,6 +791,8 @@ struct ProtocolImpl final : GlobalNode {
 
     ProtocolImpl(): GlobalNode(ND_PROTOCOL_IMPL) {}
 
+    static bool classof(const Node* node) { return node->kind == ND_PROTOCOL_IMPL; }
+
     [[nodiscard]]
     TypeWrapper* getAliasTypeFor(const std::string_view name) const {
         for (const TypeAlias* alias : type_aliases) {
@@ -909,6 +814,8 @@ struct ForLoop final : Node {
     Scope*      children = nullptr;
 
     bool        is_comptime = false;
+
+    static bool classof(const Node* node) { return node->kind == ND_FOR_LOOP; }
 };
 
 
@@ -920,13 +827,7 @@ struct Struct final : GlobalNode {
 
     explicit Struct() : GlobalNode(ND_STRUCT) {}
 
-    [[nodiscard]] NodeType getNodeType() const override {
-        return ND_STRUCT;
-    }
-
-    IdentInfo* getIdentInfo() override {
-        return ident;
-    }
+    static bool classof(const Node* node) { return node->kind == ND_STRUCT; }
 };
 
 
@@ -943,12 +844,89 @@ struct Condition final : Node {
     explicit Condition()
         : Node(ND_COND) {}
 
-
-    [[nodiscard]] Node* getExprValue() override {
-        return bool_expr->expr;
-    }
-
-    [[nodiscard]] NodeType getNodeType() const override {
-        return ND_COND;
-    }
-};
\ No newline at end of file
+    static bool classof(const Node* node) { return node->kind == ND_COND; }
+};
+
+
+/// Returns whether `node` is a `To`, `node` must not be null
+template <typename To, typename From>
+bool isa(const From* node) {
+    assert(node != nullptr && "isa<> used on a null node");
+    return To::classof(node);
+}
+
+/// Casts `node` to a `To`, which it must be
+template <typename To, typename From>
+auto cast(From* node) {
+    using Ret_t = std::conditional_t<std::is_const_v<From>, const To, To>;
+    assert(isa<To>(node) && "cast<> to an incompatible node type");
+    return static_cast<Ret_t*>(node);
+}
+
+/// Casts `node` to a `To` if it is one, returns nullptr otherwise
+template <typename To, typename From>
+auto dyn_cast(From* node) {
+    using Ret_t = std::conditional_t<std::is_const_v<From>, const To, To>;
+    return isa<To>(node) ? static_cast<Ret_t*>(node) : nullptr;
+}
+
+
+inline bool Node::isGlobal() const {
+    return isa<GlobalNode>(this);
+}
+
+inline bool Node::isLiteral() const {
+    switch (kind) {
+        case ND_INT: case ND_FLOAT: case ND_BOOL: case ND_STR: case ND_ARRAY:
+            return true;
+        default:
+            return false;
+    }
+}
+
+inline IdentInfo* Node::getIdentInfo() {
+    switch (kind) {
+        case ND_EXPR:     return cast<Expression>(this)->expr->getIdentInfo();
+        case ND_IDENT:    return cast<Ident>(this)->value;
+        case ND_VAR:      return cast<Var>(this)->var_ident;
+        case ND_FUNC:     return cast<Function>(this)->ident;
+        case ND_CALL:     return cast<FuncCall>(this)->ident->getIdentInfo();
+        case ND_PROTOCOL: return cast<Protocol>(this)->ident;
+        case ND_STRUCT:   return cast<Struct>(this)->ident;
+        default: throw std::runtime_error(std::format("getIdentInfo called on a {}", NodeTypeNames[kind]));
+    }
+}
+
+inline Node* Node::getExprValue() {
+    switch (kind) {
+        case ND_EXPR: return cast<Expression>(this)->expr;
+        case ND_VAR:  return cast<Var>(this)->value->expr;
+        case ND_COND: return cast<Condition>(this)->bool_expr->expr;
+        default: throw std::runtime_error(std::format("getExprValue called on a {}", NodeTypeNames[kind]));
+    }
+}
+
+inline Node* Node::getWrappedNodeOrInstance() {
+    if (kind == ND_EXPR) {
+        return cast<Expression>(this)->expr->getWrappedNodeOrInstance();
+    } return this;
+}
+
+inline Ident* Node::getIdent() {
+    switch (kind) {
+        case ND_IDENT: return cast<Ident>(this);
+        case ND_CALL:  return cast<FuncCall>(this)->ident;
+        default:       return nullptr;
+    }
+}
+
+inline Type* Node::getSwType() {
+    switch (kind) {
+        case ND_EXPR:  return cast<Expression>(this)->expr_type;
+        case ND_OP:    return cast<Op>(this)->common_type;
+        case ND_TYPE:  return cast<TypeWrapper>(this)->type;
+        case ND_CALL:  return cast<FuncCall>(this)->signature;
+        case ND_ARRAY: return cast<ArrayLit>(this)->type;
+        default: throw std::runtime_error(std::format("getSwType: unimplemented for {}", NodeTypeNames[kind]));
+    }
+}
@@ -1,14 +1,52 @@
 #pragma once
+#include <limits>
+#include <cstdint>
+#include <algorithm>
+
 #include "lexer/TokenStream.h"
+#include "utils/FileSystem.h"
 
 
+/// A range of a module's source. The line and column are not stored, they are recovered on demand from
+/// the line-table of the module's `sw::FileHandle`, which keeps the nodes small.
 struct SourceLocation {
-    StreamState     from;
-    StreamState     to;
-    sw::FileHandle* source = nullptr;
+    std::uint32_t offset = 0;  // of the first char
+    std::uint32_t length = 0;
+
+    /// The last offset a location can refer to, the ranges past it (in sources over 4 GiB) are clamped
+    static constexpr std::size_t MaxOffset = std::numeric_limits<std::uint32_t>::max();
+
+    /// The range [from, to), an inverted one is treated as empty
+    static SourceLocation fromRange(const std::size_t from, const std::size_t to) {
+        const auto start = std::min(from, MaxOffset);
+        const auto end   = std::clamp(to, start, MaxOffset);
+        return {static_cast<std::uint32_t>(start), static_cast<std::uint32_t>(end - start)};
+    }
+
+    /// The location of `token`, whose start is inferred from its spelling
+    static SourceLocation ofToken(const Token& token) {
+        const auto end = token.location.Pos;
+        return fromRange(end - std::min(end, token.value.size()), end);
+    }
+
+    [[nodiscard]] std::size_t end() const { return static_cast<std::size_t>(offset) + length; }
+
+    /// Returns false for a default-constructed location
+    [[nodiscard]] bool isSet() const { return offset != 0 || length != 0; }
+
+    /// Sets the end of the range, keeping its start
+    void setEnd(const std::size_t to) {
+        length = static_cast<std::uint32_t>(std::clamp<std::size_t>(to, offset, MaxOffset) - offset);
+    }
+
+    /// Returns the (1-based) line and column of the first char
+    [[nodiscard]] sw::FileHandle::LineColumn getStart(sw::FileHandle* file) const {
+        return file->getLineColumn(offset);
+    }
 
     [[nodiscard]]
-    std::string toString() const {
-        return std::format("{}:{}", from.Line, from.Col);
+    std::string toString(sw::FileHandle* file) const {
+        const auto [line, column] = getStart(file);
+        return std::format("{}:{}", line, column);
     }
 };
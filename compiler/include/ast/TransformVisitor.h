@@ -644,7 +644,7 @@ protected:
 
     [[nodiscard]]
     std::string_view internString(const std::string_view str) const {
-        return m_Module->getStringPool().internLocked(str);
+        return m_Module->getStringPool().intern(str);
     }
 
     constexpr Derived* derived() {
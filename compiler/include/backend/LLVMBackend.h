@@ -162,6 +162,16 @@ public:
     }
 
 
+    /// Creates a new TargetMachine for `CompilerInst::Target`. A TargetMachine must not be shared
+    /// between threads which emit code concurrently, hence each emission task creates its own.
+    static std::unique_ptr<llvm::TargetMachine> createTargetMachine();
+
+    /// Runs the IR optimization pipeline matching `CompilerInst::OptimizationLevel` on the module
+    void optimize(llvm::TargetMachine* target_machine);
+
+    /// Writes the module as an object file to `path`
+    void emitObjectFile(const std::string& path, llvm::TargetMachine* target_machine);
+
     /// Calls `print` on the llvm module after verification
     void printIR() const {
         verifyModule(*LModule, &llvm::errs());
@@ -64,13 +64,13 @@ public:
                 return const_cast<Expression*>(node);
             }
 
-            expr->to<Expression>()->expr_type = node->expr_type;
-            assert(expr->to<Expression>()->expr_type);
+            cast<Expression>(expr)->expr_type = node->expr_type;
+            assert(cast<Expression>(expr)->expr_type);
             return expr;
         }
 
         const auto expr = const_cast<Node*>(transformDefault(node));
-        expr->to<Expression>()->expr_type = node->expr_type;
+        cast<Expression>(expr)->expr_type = node->expr_type;
         assert(node->expr_type);
         return expr;
     }
@@ -91,7 +91,7 @@ public:
         const auto ret = const_cast<Node*>(transformDefault(node));
         if (ret != node) {
             // set the ident to the old one as transformation nullifies it
-            ret->to<Function>()->ident = node->ident;
+            cast<Function>(ret)->ident = node->ident;
         } return ret;
     }
 
@@ -100,7 +100,7 @@ public:
         const auto ret = const_cast<Node*>(transformDefault(node));
         if (ret != node) {
             // set the var_ident to what it was before, as transformation nullifies it
-            auto* var = ret->to<Var>();
+            auto* var = cast<Var>(ret);
             var->var_ident = node->var_ident;
         } return ret;
     }
@@ -109,7 +109,7 @@ public:
     Node* transform(const Struct* node) {
         const auto ret = const_cast<Node*>(transformDefault(node));
         if (ret != node) {
-            auto* struct_ = ret->to<Struct>();
+            auto* struct_ = cast<Struct>(ret);
             struct_->ident = node->ident;
         } return ret;
     }
@@ -171,7 +171,7 @@ private:
                 const auto operand_ty = node->operands.at(0)->getWrappedNodeOrInstance();
                 assert(operand_ty->getNodeType() == ND_TYPE);
 
-                const auto ty = operand_ty->to<TypeWrapper>()->type;
+                const auto ty = cast<TypeWrapper>(operand_ty)->type;
                 assert(ty != nullptr);
 
                 return Value::makeInt(m_Module->getTarget().getSizeInBits(ty) / 8);
@@ -180,7 +180,7 @@ private:
                 const auto operand_ty = node->operands.at(0)->getWrappedNodeOrInstance();
                 assert(operand_ty->getNodeType() == ND_TYPE);
 
-                const auto ty = operand_ty->to<TypeWrapper>()->type;
+                const auto ty = cast<TypeWrapper>(operand_ty)->type;
                 assert(ty != nullptr);
 
                 return Value::makeInt(m_Module->getTarget().getAlignment(ty));
@@ -235,7 +235,7 @@ private:
             const auto enum_node = SymMan.getFictitiousIDValue(node->value);
             return Value{
                 .type    = Value::INT,
-                .val_int = enum_node->entries.at(node->value->toString())
+                .val_int = enum_node->getValueOf(node->value->toString())
             };
         }
 
@@ -389,7 +389,7 @@ private:
 
     [[nodiscard]]
     std::string_view internStr(const std::string& str) const {
-        return m_Module->getStringPool().internLocked(str);
+        return m_Module->getStringPool().intern(str);
     }
 
 
@@ -14,21 +14,21 @@ class ErrorPipeline {
 public:
     /// Responsible for buffering the raw error message and error context.
     virtual void write(const std::string_view message, const ErrorContext& ctx) {
+        const auto [line, column] = ctx.location->getStart(ctx.module->file_handle);
+        const auto source_line = ctx.module->getLineAt(line);
+
         std::string backticks;
-        backticks.resize(std::format("{} ", ctx.location->from.Line).size());
+        backticks.resize(std::format("{} ", line).size());
         std::fill(backticks.begin(), backticks.end(), ' ');
 
         backticks.append("|\t");
-        for (int i = 0; i < ctx.location->from.Col-1; i++) {
-            backticks.append(" ");
-        }
+        backticks.append(column - 1, ' ');
 
         // TODO: make this entire thing more robust, handle errors which span multiple lines
         backticks.append("^");
-        if (ctx.location->from.Col == ctx.location->to.Col) {
-            for (int i = 0; i < (ctx.location->to.Col - ctx.location->from.Col); i++) {
-                backticks.append("~");
-            }
+        if (const auto length = ctx.location->length; length > 1 && column - 1 + length <= source_line.size()) {
+            if (source_line.substr(column - 1, length).find('\n') == std::string_view::npos)
+                backticks.append(length - 1, '~');
         }
 
         m_ErrorBuffer += std::format(
@@ -37,10 +37,10 @@ public:
             "{}\n"        // spaces and the `^`
             "\n\tError: {}\n\n",
             ctx.module->file_handle->getPath().string(),
-            ctx.location->from.Line,
-            ctx.location->from.Col,
-            ctx.location->from.Line,
-            ctx.module->getLineAt(ctx.location->from.Line),
+            line,
+            column,
+            line,
+            source_line,
             backticks,
             message
         );
@@ -71,7 +71,7 @@ public:
     virtual ~ErrorPipeline() = default;
 
 
-private:
+protected:
     std::string m_ErrorBuffer;
     uint32_t    m_ErrorCounter = 0;
 };
@@ -0,0 +1,160 @@
+#pragma once
+#include <span>
+#include <array>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+
+#include "lexer/Tokens.h"
+
+
+/// A keyword's or operator's spelling along with its token
+struct Spelling {
+    std::string_view  text;
+    TokenCategory     type;
+    Token::TokenValue id;
+};
+
+
+/// A perfect hash over a fixed set of spellings, built at compile-time. A spelling is keyed on its length
+/// and its first, last and middle chars (the middle one tells e.g. `continue` and `comptime` apart), the key
+/// is then scrambled by a multiplier which is searched for such that no two spellings share a slot.
+/// A lookup costs a multiplication and at most one comparison.
+template <std::size_t N>
+class PerfectHashTable {
+    static constexpr std::size_t  Bits  = 8;
+    static constexpr std::uint8_t Empty = UINT8_MAX;
+    static_assert(N < Empty);
+
+    std::array<Spelling, N> m_Spellings;
+    std::array<std::uint8_t, 1 << Bits> m_Slots{};
+    std::uint32_t m_Multiplier = 0;
+    std::size_t   m_MaxLength  = 0;
+
+    static constexpr std::uint32_t keyOf(const std::string_view str) {
+        const auto byte = [](const char c) { return static_cast<std::uint32_t>(static_cast<unsigned char>(c)); };
+        return byte(str.front()) | byte(str.back()) << 8 | byte(str[str.size() / 2]) << 16
+            | static_cast<std::uint32_t>(str.size()) << 24;
+    }
+
+    [[nodiscard]] constexpr std::size_t slotOf(const std::string_view str) const {
+        return static_cast<std::uint32_t>(keyOf(str) * m_Multiplier) >> (32 - Bits);
+    }
+
+    constexpr bool tryMultiplier(const std::uint32_t multiplier) {
+        m_Multiplier = multiplier;
+        m_Slots.fill(Empty);
+
+        for (std::size_t i = 0; i < N; i++) {
+            auto& slot = m_Slots[slotOf(m_Spellings[i].text)];
+            if (slot != Empty) return false;
+            slot = static_cast<std::uint8_t>(i);
+        } return true;
+    }
+
+public:
+    constexpr explicit PerfectHashTable(const std::array<Spelling, N>& spellings): m_Spellings(spellings) {
+        for (const auto& spelling : spellings)
+            m_MaxLength = std::max(m_MaxLength, spelling.text.size());
+
+        // odd multipliers only, starting from the golden ratio's (as in Fibonacci hashing)
+        for (std::uint32_t multiplier = 0x9E3779B1, tries = 0; !tryMultiplier(multiplier); multiplier += 2) {
+            if (++tries == 50'000) throw std::logic_error("PerfectHashTable: no collision-free multiplier found");
+        }
+    }
+
+    /// Returns the spelling equal to `str`, or nullptr
+    [[nodiscard]] constexpr const Spelling* find(const std::string_view str) const {
+        if (str.empty() || str.size() > m_MaxLength)
+            return nullptr;
+
+        const auto index = m_Slots[slotOf(str)];
+        if (index == Empty || m_Spellings[index].text != str)
+            return nullptr;
+        return &m_Spellings[index];
+    }
+
+    [[nodiscard]] constexpr std::size_t getMaxLength() const { return m_MaxLength; }
+    [[nodiscard]] constexpr std::span<const Spelling> getSpellings() const { return m_Spellings; }
+};
+
+
+/// The keywords, along with the operators which are spelled like identifiers
+inline constexpr PerfectHashTable KeywordTable{std::to_array<Spelling>({
+    {"return",    KEYWORD, Token::KW_RETURN},
+    {"if",        KEYWORD, Token::KW_IF},
+    {"else",      KEYWORD, Token::KW_ELSE},
+    {"for",       KEYWORD, Token::KW_FOR},
+    {"in",        KEYWORD, Token::KW_IN},
+    {"while",     KEYWORD, Token::KW_WHILE},
+    {"mut",       KEYWORD, Token::KW_MUT},
+    {"true",      KEYWORD, Token::KW_TRUE},
+    {"false",     KEYWORD, Token::KW_FALSE},
+    {"undefined", KEYWORD, Token::KW_UNDEFINED},
+    {"enum",      KEYWORD, Token::KW_ENUM},
+    {"protocol",  KEYWORD, Token::KW_PROTOCOL},
+    {"const",     KEYWORD, Token::KW_CONST},
+    {"static",    KEYWORD, Token::KW_STATIC},
+    {"break",     KEYWORD, Token::KW_BREAK},
+    {"continue",  KEYWORD, Token::KW_CONTINUE},
+    {"elif",      KEYWORD, Token::KW_ELIF},
+    {"extern",    KEYWORD, Token::KW_EXTERN},
+    {"comptime",  KEYWORD, Token::KW_COMPTIME},
+    {"let",       KEYWORD, Token::KW_LET},
+    {"import",    KEYWORD, Token::KW_IMPORT},
+    {"export",    KEYWORD, Token::KW_EXPORT},
+    {"var",       KEYWORD, Token::KW_VAR},
+    {"fn",        KEYWORD, Token::KW_FN},
+    {"volatile",  KEYWORD, Token::KW_VOLATILE},
+    {"struct",    KEYWORD, Token::KW_STRUCT},
+    {"type",      KEYWORD, Token::KW_TYPE},
+    {"impl",      KEYWORD, Token::KW_IMPL},
+
+    {"as",      OP, Token::OP_AS},
+    {"alignof", OP, Token::OP_ALIGNOF},
+    {"sizeof",  OP, Token::OP_SIZEOF},
+    {"typeof",  OP, Token::OP_TYPEOF},
+})};
+
+
+/// The operators made of op-chars, `...` is left out as it is recognized in the context of `.`
+inline constexpr PerfectHashTable OperatorTable{std::to_array<Spelling>({
+    {"=",   OP, Token::OP_ASSIGN},
+    {"==",  OP, Token::OP_EQ},
+    {"+",   OP, Token::OP_PLUS},
+    {"+=",  OP, Token::OP_PLUS_ASSIGN},
+    {"-",   OP, Token::OP_MINUS},
+    {"-=",  OP, Token::OP_MINUS_ASSIGN},
+    {"*",   OP, Token::OP_MUL},
+    {"*=",  OP, Token::OP_MUL_ASSIGN},
+    {"**",  OP, Token::OP_EXP},
+    {"**=", OP, Token::OP_EXP_ASSIGN},
+    {"/",   OP, Token::OP_DIV},
+    {"/=",  OP, Token::OP_DIV_ASSIGN},
+    {"//",  OP, Token::OP_COMMENT},
+    {"%",   OP, Token::OP_MOD},
+    {"%=",  OP, Token::OP_MOD_ASSIGN},
+    {":",   OP, Token::PUNC_COLON},
+    {"::",  OP, Token::OP_SCOPE_RES},
+    {"|",   OP, Token::OP_BITWISE_OR},
+    {"||",  OP, Token::OP_LOGICAL_OR},
+    {"|=",  OP, Token::OP_BITWISE_OR_ASSIGN},
+    {"&",   OP, Token::OP_BITWISE_AND},
+    {"&&",  OP, Token::OP_LOGICAL_AND},
+    {"&=",  OP, Token::OP_BITWISE_AND_ASSIGN},
+    {"!",   OP, Token::OP_NOT},
+    {"!=",  OP, Token::OP_NOT_EQ},
+    {">",   OP, Token::OP_GT},
+    {">=",  OP, Token::OP_GT_EQ},
+    {">>",  OP, Token::OP_RBITSHIFT},
+    {">>=", OP, Token::OP_RBITSHIFT_ASSIGN},
+    {"<",   OP, Token::OP_LT},
+    {"<=",  OP, Token::OP_LT_EQ},
+    {"<<",  OP, Token::OP_LBITSHIFT},
+    {"<<=", OP, Token::OP_LBITSHIFT_ASSIGN},
+    {"^",   OP, Token::OP_XOR},
+    {"^=",  OP, Token::OP_XOR_ASSIGN},
+    {"~",   OP, Token::OP_BITWISE_NOT},
+    {".",   OP, Token::OP_DOT},
+})};
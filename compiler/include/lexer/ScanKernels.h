@@ -0,0 +1,35 @@
+#pragma once
+#include <span>
+#include <string_view>
+
+
+namespace sw {
+
+/// The byte-scanning routines the lexer spends most of its time in. Each one returns the first position
+/// in `[p, end)` which stops the run (or `end`), there are scalar, SSE4.2 and AVX2 implementations.
+struct ScanKernels {
+    std::string_view name;
+
+    /// Skips identifier chars, i.e. `[A-Za-z0-9_]`
+    const char* (*skipIdent)(const char* p, const char* end);
+
+    /// Skips decimal digits and digit-separators, i.e. `[0-9_]`
+    const char* (*skipDigits)(const char* p, const char* end);
+
+    /// Skips whitespace, i.e. `' '` and `[\t-\r]`, the other control chars are left to the tokenizer
+    const char* (*skipWhitespace)(const char* p, const char* end);
+
+    /// Finds the first occurrence of either `a` or `b`
+    const char* (*findEither)(const char* p, const char* end, char a, char b);
+};
+
+
+/// Returns the fastest kernels supported by the CPU, picked (through CPUID) on the first call
+const ScanKernels& getScanKernels();
+
+/// Returns the portable, scalar kernels
+const ScanKernels& getScalarScanKernels();
+
+/// Returns every set of kernels the CPU supports, the scalar ones first
+std::span<const ScanKernels* const> getSupportedScanKernels();
+}
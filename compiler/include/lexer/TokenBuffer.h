@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+#include "lexer/Tokens.h"
+
+
+/// The tokens of an entire file, lexed up front and stored as parallel arrays (struct-of-arrays).
+/// A token's value is `length` bytes of the source at `offset`, unless it doesn't appear verbatim in the
+/// source (e.g. unescaped strings) or is too long, then it is "spilled": `offset` indexes a side-table
+/// and `length` is `Spilled`. The locations are recomputed from the end offsets through a line-table.
+/// The buffer always ends with the EOF (`NONE`) token.
+class TokenBuffer {
+public:
+    using u16 = std::uint16_t;
+    using u32 = std::uint32_t;
+
+    static constexpr u16 Spilled = UINT16_MAX;
+
+    TokenBuffer() = default;
+    explicit TokenBuffer(std::string_view source);
+
+    void push(const Token& token);
+
+    [[nodiscard]] std::size_t size() const { return m_Kinds.size(); }
+    [[nodiscard]] bool empty() const { return m_Kinds.empty(); }
+
+    [[nodiscard]] TokenCategory getKind(const std::size_t i) const { return static_cast<TokenCategory>(m_Kinds[i]); }
+    [[nodiscard]] Token::TokenValue getId(const std::size_t i) const { return static_cast<Token::TokenValue>(m_Ids[i]); }
+    [[nodiscard]] std::string_view getValue(std::size_t i) const;
+
+    /// Returns the stream-state right after the `i`th token, as the on-demand lexer would report it
+    [[nodiscard]] StreamState getLocation(std::size_t i) const;
+
+    /// Reassembles the `i`th token
+    [[nodiscard]] Token operator[](const std::size_t i) const {
+        return {getKind(i), getValue(i), getLocation(i), getId(i)};
+    }
+
+private:
+    std::string_view m_Source;
+
+    std::vector<std::uint8_t> m_Kinds;
+    std::vector<u16> m_Ids;
+    std::vector<u32> m_Offsets;
+    std::vector<u16> m_Lengths;
+    std::vector<u32> m_Ends;
+
+    std::vector<std::string_view> m_Spilled;
+    std::vector<u32> m_LineStarts;
+};
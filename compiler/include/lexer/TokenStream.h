@@ -1,15 +1,25 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <algorithm>
 
 #include "lexer/Tokens.h"
+#include "lexer/ScanKernels.h"
+#include "lexer/TokenBuffer.h"
 #include "managers/SourceManager.h"
+#include "utils/StringPool.h"
 
 
 class TokenStream {
     StreamState     m_Cache;    // For caching stream state
     std::vector<Token> m_Pushback;  // Token pushback buffer for generic arg >> splitting
     SourceManager&  m_Stream;
+    sw::StringPool& m_StringPool;  // holds the token-values which don't appear verbatim in the source
+    const sw::ScanKernels* m_Kernels = &sw::getScanKernels();
+
+    TokenBuffer m_Buffer;          // the whole file's tokens, once pre-tokenized
+    std::size_t m_Index = 0;       // no. of tokens consumed from `m_Buffer`
+    std::size_t m_CachedIndex = 0;
 
     bool m_isPreviousTokIdent = false;
 
@@ -20,7 +30,7 @@ class TokenStream {
         std::vector<TokenCategory> expected_types;
     }                           m_Filter;
 
-    static bool isKeyword(const std::string& _str);
+    static bool isKeyword(std::string_view _str);
     static bool isDigit( char chr);
     static bool isHexDigit( char chr);
     static bool isOctalDigit( char chr);
@@ -29,30 +39,66 @@ class TokenStream {
     static bool isId( char chr);
     static bool isOpChar( char _chr);
 
-    [[nodiscard]] std::string readEscaped( char _end) const;
+    [[nodiscard]] std::string_view readEscaped( char _end) const;
     [[nodiscard]] Token readString( char del) const;
 
+    /// Returns the source text from `from` up to the current position
+    [[nodiscard]] std::string_view sourceFrom(const std::size_t from) const {
+        return m_Stream.getSource().substr(from, m_Stream.getStreamState().Pos - from);
+    }
+
+    /// Consumes chars while `pred` holds, returns a view of them, beginning with the current char
     template <typename Fn> requires std::invocable<Fn, char> 
         && std::same_as<std::invoke_result_t<Fn, char>, bool>
-    std::string readWhile(const Fn pred) {
-        std::string ret(1, m_Stream.getCurrentChar());
+    std::string_view readWhile(const Fn pred) {
+        const auto from = m_Stream.getStreamState().Pos - 1;
 
         while (!m_Stream.eof() && pred(m_Stream.peek()))
-            ret += m_Stream.next();
-        return ret;
+            m_Stream.next();
+        return sourceFrom(from);
+    }
+
+    /// Like `readWhile`, but consumes the whole run at once through `skip`, one of the scanning kernels
+    template <typename Fn> requires std::invocable<Fn, const char*, const char*>
+    std::string_view readRun(const Fn skip) {
+        const auto from = m_Stream.getStreamState().Pos - 1;
+        const auto src  = m_Stream.getSource();
+
+        m_Stream.advanceTo(skip(src.data() + from + 1, src.data() + src.size()) - src.data());
+        return sourceFrom(from);
     }
-    
+
+    /// Consumes the whitespace ahead, which (as any token) ends a preceding identifier
+    void skipWhitespace() {
+        const auto src = m_Stream.getSource();
+        const auto pos = m_Stream.getStreamState().Pos;
+        const char* stop = m_Kernels->skipWhitespace(src.data() + pos, src.data() + src.size());
+        if (stop == src.data() + pos) return;
+
+        m_Stream.advanceTo(stop - src.data());
+        m_isPreviousTokIdent = false;
+    }
+
+    /// Like `readWhile(pred)`, the chars (except the first) which match `filter` are dropped, in which case
+    /// the result is interned, otherwise it views the source
     template <typename PredFn, typename FilterFn> requires std::invocable<PredFn, char> 
         && std::same_as<std::invoke_result_t<PredFn, char>, bool>
         && std::invocable<FilterFn, char>
         && std::same_as<std::invoke_result_t<FilterFn, char>, bool>
-    std::string readWhile(const PredFn pred, FilterFn filter) {
-        std::string ret(1, m_Stream.getCurrentChar());
+    std::string_view readWhile(const PredFn pred, FilterFn filter) {
+        return dropIf(readWhile(pred), filter);
+    }
 
-        while (!m_Stream.eof() && pred(m_Stream.peek()))
-            if (filter(m_Stream.peek())) m_Stream.next();
-            else ret += m_Stream.next();
-        return ret;
+    template <typename FilterFn>
+    std::string_view dropIf(const std::string_view str, FilterFn filter, const std::string_view prefix = {}) {
+        if (prefix.empty() && std::ranges::none_of(str.substr(1), filter))
+            return str;
+
+        std::string ret{prefix};
+        ret += str.front();
+        for (const char chr : str.substr(1)) {
+            if (!filter(chr)) ret += chr;
+        } return m_StringPool.intern(ret);
     }
 
     Token readNextTok();
@@ -62,10 +108,29 @@ public:
     Token CurTok;
     Token PeekTok;
 
-    explicit TokenStream(SourceManager& src_man);
+    TokenStream(SourceManager& src_man, sw::StringPool& string_pool);
+
+    /// Overrides the scanning kernels picked for the CPU, the tokens must come out the same regardless
+    void setScanKernels(const sw::ScanKernels& kernels) { m_Kernels = &kernels; }
+
+    /// Lexes the rest of the file into a token buffer, the stream is served from it afterward, which
+    /// makes lookahead and backtracking a matter of moving an index
+    void pretokenize();
+
+    /// Serves the stream from `buffer`, the tokens of the same source lexed by another stream's `pretokenize`
+    void adoptTokenBuffer(TokenBuffer buffer) {
+        m_Buffer = std::move(buffer);
+        m_Index  = 0;
+    }
+
+    /// Moves the tokens out, after which the stream must not be used anymore
+    TokenBuffer takeTokenBuffer() { return std::move(m_Buffer); }
+
+    [[nodiscard]] bool isPretokenized() const { return !m_Buffer.empty(); }
+    [[nodiscard]] const TokenBuffer& getTokenBuffer() const { return m_Buffer; }
 
     void setReturnPoint();
-    void restoreCache() const;
+    void restoreCache();
 
     /// what token *types* are expected next
     [[deprecated]] void expectTypes(std::initializer_list<TokenCategory>&& types);
@@ -3,6 +3,7 @@
 #include <unordered_map>
 #include <string_view>
 #include <concepts>
+#include <type_traits>
 
 
 enum TokenCategory {
@@ -122,7 +123,7 @@ struct Token {
     };
 
     TokenCategory type{};
-    std::string value;
+    std::string_view value;  // views the source buffer, or the string pool when the text had to be rewritten
     StreamState location{};
 
     TokenValue tokenid{};
@@ -140,39 +141,7 @@ struct Token {
     static std::string_view toString(TokenValue v);
 };
 
-
-inline const
-std::unordered_map<std::string_view, Token::TokenValue>
-KeywordMap = {
-    {"return", Token::KW_RETURN},
-    {"if", Token::KW_IF},
-    {"else", Token::KW_ELSE},
-    {"for", Token::KW_FOR},
-    {"in", Token::KW_IN},
-    {"while", Token::KW_WHILE},
-    {"mut", Token::KW_MUT},
-    {"true", Token::KW_TRUE},
-    {"false", Token::KW_FALSE},
-    {"undefined", Token::KW_UNDEFINED},
-    {"enum", Token::KW_ENUM},
-    {"protocol", Token::KW_PROTOCOL},
-    {"const", Token::KW_CONST},
-    {"static", Token::KW_STATIC},
-    {"break", Token::KW_BREAK},
-    {"continue", Token::KW_CONTINUE},
-    {"elif", Token::KW_ELIF},
-    {"extern", Token::KW_EXTERN},
-    {"comptime", Token::KW_COMPTIME},
-    {"let", Token::KW_LET},
-    {"import", Token::KW_IMPORT},
-    {"export", Token::KW_EXPORT},
-    {"var", Token::KW_VAR},
-    {"fn", Token::KW_FN},
-    {"volatile", Token::KW_VOLATILE},
-    {"struct", Token::KW_STRUCT},
-    {"type", Token::KW_TYPE},
-    {"impl", Token::KW_IMPL},
-};
+static_assert(std::is_trivially_copyable_v<Token>);
 
 
 inline std::string_view Token::toString(const TokenValue v) {
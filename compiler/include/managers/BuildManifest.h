@@ -0,0 +1,94 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+#include <unordered_map>
+
+
+struct Module;
+class  ModuleManager;
+
+
+/// Persists the fingerprints of the modules of the previous build (in `.build/manifest`), so that
+/// modules whose inputs did not change can reuse their object files.
+class BuildManifest {
+public:
+    /// Everything the object file of a module depends upon
+    struct Entry {
+        std::uint64_t source_hash = 0;  // the module's own source
+        std::uint64_t deps_hash   = 0;  // the exported interfaces of its dependencies
+        std::uint64_t config_hash = 0;  // the target-triple, flags and compiler version
+
+        bool operator==(const Entry&) const = default;
+    };
+
+    explicit BuildManifest(std::filesystem::path path): m_Path(std::move(path)) {}
+
+    /// Reads the manifest from the disk, a missing or malformed manifest results in an empty one
+    void load();
+
+    /// Writes the manifest to the disk
+    void save() const;
+
+    /// Returns true if `uid` was recorded with the exact same fingerprint
+    [[nodiscard]] bool matches(const std::string& uid, const Entry& entry) const {
+        const auto it = m_Entries.find(uid);
+        return it != m_Entries.end() && it->second == entry;
+    }
+
+    void set(const std::string& uid, const Entry& entry) {
+        m_Entries[uid] = entry;
+    }
+
+    void clear() {
+        m_Entries.clear();
+    }
+
+private:
+    std::filesystem::path m_Path;
+    std::unordered_map<std::string, Entry> m_Entries;
+};
+
+
+/// Computes the fingerprints of the modules of a build. A module's dependents need to be rebuilt only when its
+/// interface hash (its exported globals, together with the interfaces of its dependencies) changes.
+///
+/// The modules of an import cycle see one another's interfaces, hence each cycle (a strongly connected component
+/// of the import graph) is hashed as a whole, its members in the order of their UIDs. The hashes therefore do
+/// not depend on the order the modules are visited in.
+class ModuleFingerprinter {
+public:
+    ModuleFingerprinter(const ModuleManager& module_man, const std::uint64_t config_hash)
+        : m_ModuleManager(module_man), m_ConfigHash(config_hash) {}
+
+    /// Everything the object file of `module` depends upon
+    BuildManifest::Entry getEntry(Module* module);
+
+    std::uint64_t getInterfaceHash(Module* module);
+
+private:
+    struct VisitState {
+        std::size_t index    = 0;
+        std::size_t low_link = 0;
+        bool on_stack = false;
+    };
+
+    const ModuleManager& m_ModuleManager;
+    std::uint64_t m_ConfigHash;
+
+    std::unordered_map<Module*, std::uint64_t> m_InterfaceHashes;
+    std::unordered_map<Module*, VisitState>    m_VisitStates;
+    std::vector<Module*> m_VisitStack;
+    std::size_t m_NextIndex = 0;
+
+    /// Combines the interface hashes of the dependencies of `module`, ordered by their UIDs
+    std::uint64_t hashDependencies(Module* module);
+
+    /// Finds the components of the import graph reachable from `module` (Tarjan's algorithm) and hashes them
+    void visit(Module* module);
+
+    void hashComponent(std::vector<Module*>& component);
+
+    const std::string& getUID(const Module* module) const;
+};
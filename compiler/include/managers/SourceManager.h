@@ -1,5 +1,5 @@
 #pragma once
-#include <vector>
+#include <string_view>
 #include <filesystem>
 
 
@@ -8,14 +8,12 @@ struct Module;
 struct SourceLocation;
 namespace sw { class FileHandle; }
 
+/// Walks over the source of a module, which is a view of the buffer owned by its `sw::FileHandle`.
 class SourceManager {
     std::tuple<size_t, size_t, size_t> cache;
-    std::string m_CurrentLine;
-    std::string m_Source;
+    std::string_view m_Source;
 
-    std::filesystem::path m_SourcePath;
-
-    std::vector<std::array<std::size_t, 2>>& m_LineOffsets;  // (line no. - 1) : {its starting pos, size}
+    sw::FileHandle* m_FileHandle;
     std::size_t Pos = 0, Line = 1, Col = 0;
 
 public:
@@ -30,6 +28,9 @@ public:
     /** @brief returns the next value and discards it */
     char next();
 
+    /** @brief consumes the chars up to `pos`, as if `next()` was called till then */
+    void advanceTo(std::size_t pos);
+
     [[nodiscard]] char getCurrentChar() const;
 
     [[nodiscard]] bool almostEOF() const;
@@ -40,13 +41,15 @@ public:
     /** @brief resets the state of the m_Stream */
     void reset();
 
-    /** @brief returns a const-ref to the source's path */
-    [[nodiscard]] const std::filesystem::path& getSourcePath() const {
-        return m_SourcePath;
+    /** @brief returns a view of the entire source */
+    [[nodiscard]] std::string_view getSource() const {
+        return m_Source;
     }
 
-    [[nodiscard]] std::string getLineAt(std::size_t) const;
-    [[nodiscard]] std::string getCurrentLine() const;
+    /** @brief returns a const-ref to the source's path */
+    [[nodiscard]] const std::filesystem::path& getSourcePath() const;
+
+    [[nodiscard]] std::string_view getLineAt(std::size_t) const;
 
     void setStreamState(const StreamState &to);
     [[nodiscard]] StreamState getStreamState() const;
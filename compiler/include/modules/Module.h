@@ -1,4 +1,6 @@
 #pragma once
+#include <array>
+#include <atomic>
 #include <vector>
 #include <memory>
 #include <expected>
@@ -8,6 +10,7 @@
 #include "parser/Parser.h"
 #include "utils/BumpAllocator.h"
 #include "utils/FileSystem.h"
+#include "utils/TimeTrace.h"
 
 
 class ModuleManager;
@@ -27,6 +30,11 @@ struct ModuleContext {
 
 
 struct Module {
+private:
+    // declared first, the symbol table allocates its `IdentInfo`s from it
+    sw::BumpAllocator m_Allocator{64 * 1024};
+
+public:
     AST_t ast{};
     SymbolManager symbol_table;
     sw::FileHandle* file_handle = nullptr;
@@ -58,11 +66,17 @@ struct Module {
     /// all modules which directly or indirectly depend on this one
     std::unordered_set<Module*> cumulative_dependents{};
 
-    /// counter for the no. of unresolved dependencies
-    std::size_t unresolved_deps{};
+    /// counter for the no. of dependencies which haven't been processed yet by the scheduler
+    std::atomic<std::size_t> unresolved_deps{};
+
+    /// set when the object file of the previous build can be reused for this module
+    bool is_up_to_date = false;
+
+    /// set when sema must run, i.e. the module is stale or a stale module depends on it
+    bool requires_sema = true;
 
-    /// Decrements the unresolved-deps counter of dependents
-    void decrementUnresolvedDeps();
+    /// Marks one of the dependencies as processed, returns true if it was the last one
+    bool resolveDependency();
 
     /// Returns whether this module is the main one
     bool isMainModule() const { return m_IsMainModule; }
@@ -75,8 +89,17 @@ struct Module {
     /// Marks the module as erroneous
     void markErroneous() { m_IsErroneous = true; }
 
+    /// Lexes the whole module ahead of parsing it, so that it can be done on another thread. The parser
+    /// takes the tokens over.
+    void pretokenize();
+
+    /// Hands the tokens lexed by `pretokenize` over, the buffer is empty if it wasn't called
+    TokenBuffer takeTokens() { return std::move(m_Tokens); }
+
     /// Creates a Parser instance and begins parsing
     void parse(const ErrorCallback_t& error_callback) {
+        // includes the lexing too, unless the module was pre-tokenized
+        sw::TimeScope scope{"parse", file_handle->getPath()};
         auto context = ParserContext{this, error_callback, m_ModuleManager, m_StringPool};
         const auto parser = std::make_unique<Parser>(context);
         parser->parse();
@@ -90,8 +113,7 @@ struct Module {
     template <typename Inserter_t> requires std::invocable<Inserter_t, std::string_view>
     void insertExportedSymbolsInto(Inserter_t inserter) {
         for (const auto& node : ast) {
-            if (node->isGlobal()) {
-                const auto glob_node = node->to<GlobalNode>();
+            if (const auto glob_node = dyn_cast<GlobalNode>(node)) {
                 if (glob_node->is_exported && !glob_node->name.empty()) {
                     inserter(glob_node->name);
                 }
@@ -103,11 +125,10 @@ struct Module {
     requires std::derived_from<T, Node>
     T* makeNode(Args&&... args) {
         T* ret = m_Allocator.construct<T>(std::forward<Args>(args)...);
-        if constexpr (!std::is_trivially_destructible_v<T>) {
-            m_Destructors.push_back([ret] {
-               ret->~T();
-           });
-        } return ret;
+        auto& [count, bytes] = m_NodeStats[ret->getNodeType()];
+        count++;
+        bytes += sizeof(T);
+        return ret;
     }
 
 
@@ -187,9 +208,27 @@ struct Module {
         return m_Allocator;
     }
 
+    /// The no. of nodes created through `makeNode`, along with the bytes they take
+    struct NodeStats {
+        std::size_t count = 0;
+        std::size_t bytes = 0;
+    };
+
+    /// The no. of nodes created through `makeNode` so far
+    std::size_t getNodeCount() const {
+        std::size_t ret = 0;
+        for (const auto& stats : m_NodeStats) {
+            ret += stats.count;
+        } return ret;
+    }
+
+    /// Indexed by `NodeType`
+    const std::array<NodeStats, NodeTypeCount>& getNodeStats() const {
+        return m_NodeStats;
+    }
+
     std::string_view getLineAt(const std::size_t line) const {
-        auto [from, line_size] = m_LineOffsets[line - 1];
-        return file_handle->readAll().substr(from, line_size);
+        return file_handle->getLine(line);
     }
 
     ModuleContext getModuleContext() const {
@@ -198,14 +237,6 @@ struct Module {
 
     ModuleManager& getModuleManager() const { return m_ModuleManager; }
 
-    // NOTE: the manual destructor calls is a temporary workaround until all Nodes become
-    //       trivially destructible
-    ~Module() {
-        for (auto& destructor : m_Destructors) {
-            destructor();
-        }
-    }
-
 
 private:
     bool m_IsMainModule   = false;
@@ -213,17 +244,14 @@ private:
     bool m_IsErroneous    = false;
 
     ModuleManager&    m_ModuleManager;
-    sw::BumpAllocator m_Allocator{64 * 1024};
     sw::StringPool&   m_StringPool;
     sw::Target&       m_Target;
     ModuleContext     m_CtxCopy;
 
-    std::vector<std::array<std::size_t, 2>> m_LineOffsets{};
-    std::vector<std::unique_ptr<Node*>> m_Nodes{};
-    std::vector<std::function<void()>>  m_Destructors{};
+    std::array<NodeStats, NodeTypeCount> m_NodeStats{};
 
     ProtocolImplTable m_ProtocolImplTable;
+    TokenBuffer       m_Tokens;  // set by `pretokenize`, until the parser takes them over
 
     friend class CompilerInst;
-    friend class SourceManager;
 };
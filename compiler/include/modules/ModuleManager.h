@@ -1,54 +1,70 @@
 #pragma once
+#include <mutex>
+#include <shared_mutex>
 #include <vector>
 #include <memory>
+#include <format>
+#include <ranges>
 #include <unordered_map>
 
 #include "parser/Parser.h"
+#include "utils/utils.h"
+#include "utils/Threadpool.h"
 #include "utils/BumpAllocator.h"
 #include "utils/FileSystem.h"
 #include "modules/Module.h"
+#include "types/TypeInterner.h"
 
 
 /// This is a helper class which works with the `Parser`, it manages the entire collection of modules
 /// and keeps them in a topologically sorted order (dependencies-first).
 class ModuleManager {
+    // declared first, it outlives the modules whose types it points to
+    TypeInterner m_TypeInterner;
 
     std::unordered_map<sw::FileHandle*, std::unique_ptr<Module>> m_ModuleMap;
-    std::vector<Module*> m_ZeroDepVec;  // holds modules with zero dependencies
-    std::vector<Module*> m_BackBuffer;  // this will be swapped with the above vector after flushing
     std::vector<Module*> m_OrderedMods; // keeps parsers in dependencies-dependent order, left-to-right
+    std::mutex m_OrderedModsMutex;
 
-    std::size_t m_ModCount = 0;
-    std::unordered_map<fs::path, std::size_t> m_ModuleUIDTable;
+    std::unordered_map<fs::path, std::string> m_ModuleUIDTable;
+
+    // imports are discovered by concurrent parsers, the tables above and the dependency-sets of the
+    // modules are guarded by these
+    mutable std::shared_mutex m_ModuleMapMutex;
+    std::mutex m_DependencyMutex;
 
     Module* m_MainModule = nullptr;
+    sw::ThreadPool* m_ThreadPool = nullptr;
+    bool m_Pretokenize = false;
 
     friend struct Module;
     friend class  Parser;
 
 public:
     Module& get(sw::FileHandle* m) const {
+        std::shared_lock lock(m_ModuleMapMutex);
         return *m_ModuleMap.at(m);
     }
 
-    /// pops and returns a Module which has no dependency
-    Module* popZeroDepVec() {
-        if (m_ZeroDepVec.empty())
-            return nullptr;
-
-        const auto ret = m_ZeroDepVec.back();
-        m_ZeroDepVec.pop_back();
-        m_OrderedMods.push_back(ret);
-
-        // decrement the dependency counters of all parser instances which
-        // depend on this one
-        for (Module* dependent : ret->dependents) {
-            dependent->decrementUnresolvedDeps();
-        } return ret;
-    }
+    /// Calls `task` on every module, dependencies-first. A module is submitted to the `pool` as soon as
+    /// its last dependency completes, so a slow module only holds back the modules which depend on it.
+    /// Blocks until all the modules have been processed.
+    template <typename Fn> requires std::invocable<Fn&, Module*>
+    void scheduleDependenciesFirst(sw::ThreadPool& pool, Fn task) {
+        m_OrderedMods.clear();
+        m_OrderedMods.reserve(m_ModuleMap.size());
+
+        std::vector<Module*> roots;
+        for (const auto& module : m_ModuleMap | std::views::values) {
+            module->unresolved_deps.store(module->dependencies.size(), std::memory_order_relaxed);
+            if (module->dependencies.empty()) {
+                roots.push_back(module.get());
+            }
+        }
 
-    void swapBuffers() {
-        m_ZeroDepVec = std::move(m_BackBuffer);
+        for (Module* module : roots) {
+            submit(pool, module, task);
+        } pool.wait();
     }
 
 
@@ -70,35 +86,101 @@ public:
 
     /// Create a Module entry for `path` with the given module object
     void insert(sw::FileHandle* path, Module* module) {
-        if (module->isMainModule()) {
-            m_MainModule = module;
+        std::unique_lock lock(m_ModuleMapMutex);
+        insertUnlocked(path, module);
+    }
+
+
+    /// Create a Module entry for `handle` unless one exists already, returns the module along with
+    /// whether it was created by this call (in which case the caller is responsible for parsing it)
+    std::pair<Module*, bool> tryInsert(sw::FileHandle* handle, const ModuleContext& context) {
+        std::unique_lock lock(m_ModuleMapMutex);
+        if (const auto it = m_ModuleMap.find(handle); it != m_ModuleMap.end()) {
+            return {it->second.get(), false};
         }
 
-        m_ModuleMap.emplace(path, module);
-        m_ModuleUIDTable.emplace(path->getPath(), m_ModCount);
-        m_ModCount += 1;
+        auto ctx = context;
+        ctx.file_handle = handle;
+
+        const auto ret = new Module{ctx};
+        insertUnlocked(handle, ret);
+        return {ret, true};
+    }
+
+
+    /// Records that `dependent` imports `dependency`, returns false if it had been recorded already
+    bool addDependency(Module* dependent, Module* dependency) {
+        std::lock_guard lock(m_DependencyMutex);
+        dependency->dependents.insert(dependent);
+        return dependent->dependencies.insert(dependency).second;
     }
 
 
-    bool zeroVecIsEmpty() const {
-        return m_ZeroDepVec.empty();
+    /// Sets the pool on which the modules discovered through imports are parsed
+    void setThreadPool(sw::ThreadPool* pool) {
+        m_ThreadPool = pool;
+    }
+
+    /// The structural types of the modules, shared by all of them
+    TypeInterner& getTypeInterner() {
+        return m_TypeInterner;
+    }
+
+    /// Lexes the modules in full as a task of its own, ahead of parsing them, see `parseAsync`
+    void setPretokenize(const bool pretokenize) {
+        m_Pretokenize = pretokenize;
     }
 
+    /// Parses `module` on the thread pool without waiting for it, or inline if no pool was set. When
+    /// pre-tokenizing, the module is lexed by one task, which then enqueues the one parsing it.
+    void parseAsync(Module* module, const ErrorCallback_t& error_callback) {
+        if (m_ThreadPool == nullptr) {
+            module->parse(error_callback);
+            return;
+        }
+
+        if (m_Pretokenize) {
+            m_ThreadPool->enqueue([this, module, error_callback] {
+                module->pretokenize();
+                m_ThreadPool->enqueue([module, error_callback] {
+                    module->parse(error_callback);
+                });
+            });
+            return;
+        }
+
+        m_ThreadPool->enqueue([module, error_callback] {
+            module->parse(error_callback);
+        });
+    }
+
+
     bool contains(sw::FileHandle* mod) const {
+        std::shared_lock lock(m_ModuleMapMutex);
         return m_ModuleMap.contains(mod);
     }
 
     std::size_t size() const {
+        std::shared_lock lock(m_ModuleMapMutex);
         return m_ModuleMap.size();
     }
 
+    /// Calls `fn` on every module (unlike `begin`/`end`, which only cover the modules already processed
+    /// by the scheduler), in no particular order. Must not run concurrently with the parsers.
+    template <typename Fn> requires std::invocable<Fn, Module*>
+    void forEachModule(Fn fn) const {
+        for (const auto& module : m_ModuleMap | std::views::values) {
+            fn(module.get());
+        }
+    }
+
     Module* getMainModule() const {
         return m_MainModule;
     }
 
-    std::string getModuleUID(const fs::path& path) const {
-        return path.filename().replace_extension().string() +
-               '_' + std::to_string(m_ModuleUIDTable.at(path));
+    const std::string& getModuleUID(const fs::path& path) const {
+        std::shared_lock lock(m_ModuleMapMutex);
+        return m_ModuleUIDTable.at(path);
     }
 
     auto begin()  {
@@ -116,4 +198,38 @@ public:
     auto end() const  {
         return m_OrderedMods.end();
     }
+
+private:
+    void insertUnlocked(sw::FileHandle* path, Module* module) {
+        if (module->isMainModule()) {
+            m_MainModule = module;
+        }
+
+        m_ModuleMap.emplace(path, module);
+
+        // the UID is derived from the module's path rather than its discovery order, so that the
+        // mangled names (and object files) of a module stay the same across builds
+        m_ModuleUIDTable.emplace(path->getPath(), std::format(
+            "{}_{:016x}", path->getPath().filename().replace_extension().string(),
+            hashStable(path->getPath().string())));
+    }
+
+    template <typename Fn>
+    void submit(sw::ThreadPool& pool, Module* module, Fn& task) {
+        pool.enqueue([this, &pool, module, &task] {
+            task(module);
+
+            {
+                std::lock_guard lock(m_OrderedModsMutex);
+                m_OrderedMods.push_back(module);
+            }
+
+            // the dependent which sees its counter drop to zero is the one to submit it
+            for (Module* dependent : module->dependents) {
+                if (dependent->resolveDependency()) {
+                    submit(pool, dependent, task);
+                }
+            }
+        });
+    }
 };
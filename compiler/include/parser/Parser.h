@@ -130,6 +130,11 @@ public:
     /// Returns the current token and reports an error if it doesn't match the given token id
     Token expect(Token::TokenValue tok);
 
+    /// Returns the offset of the current token's first char
+    std::size_t getTokenStart() const {
+        return SourceLocation::ofToken(m_Stream.CurTok).offset;
+    }
+
 
     /// Buffers the reported errors, also sets certain context attributes automatically
     void reportError(const ErrCode code, ErrorContext ctx = {}) {
@@ -146,14 +151,12 @@ public:
 struct Parser::NodeAttrHelper {
     /// Chief Node constructor
     NodeAttrHelper(Node* node, Parser& instance): node(node), instance(instance) {
-        if (node->isGlobal()) {
-            node->to<GlobalNode>()->is_exported = instance.m_LastSymWasExported;
+        const auto glob = dyn_cast<GlobalNode>(node);
+        if (glob) {
+            glob->is_exported = instance.m_LastSymWasExported;
         }
 
-        node->location.from = instance.m_Stream.getStreamState();
-        node->location.from.Pos -= instance.m_Stream.CurTok.value.size();
-
-        node->location.source = instance.m_FileHandle;
+        node->location.offset = instance.getTokenStart();
         instance.m_RecursionDepth++;
 
         instance.stackSafeguard();
@@ -163,8 +166,7 @@ struct Parser::NodeAttrHelper {
             instance.m_ErrorQueue.insert({node, {}});
         instance.m_ParseStack.emplace_back(node);
 
-        if (node->isGlobal()) {
-            const auto glob = dynamic_cast<GlobalNode*>(node);
+        if (glob) {
             glob->is_extern = instance.m_LastSymIsExtern;
             glob->extern_attributes = instance.m_StringPool.intern(instance.m_ExternAttributes);
 
@@ -180,10 +182,8 @@ struct Parser::NodeAttrHelper {
         instance.m_LastSymWasExported = false;
         instance.m_ExternAttributes.clear();
 
-        if (node) {
-            node->location.to = instance.m_Stream.getStreamState();
-            node->location.to.Pos -= instance.m_Stream.CurTok.value.size();
-        }
+        // the node ends where the token after it begins
+        if (node) node->location.setEnd(instance.getTokenStart());
 
         // flush all the errors
         for (auto& error : instance.m_ErrorQueue.at(node)) {
@@ -4,6 +4,7 @@
 #include "SymbolRegistrationPass.h"
 #include "SymbolResolver.h"
 #include "TypeResolver.h"
+#include "utils/TimeTrace.h"
 
 
 #define SW_SEMA_PIPELINE \
@@ -23,10 +24,11 @@ public:
 
     /// Performs sema on the entire module.
     void start() {
-    #define SW_SEMA_PASS(x, ...) \
+    #define SW_SEMA_PASS(x, ...) { \
+        sw::TimeScope scope{#x, m_Module->file_handle->getPath()}; \
         x x ## _inst{{m_Module, m_ErrorCallback, false, m_Module->getTarget()}}; \
         x ## _inst.dispatch(m_Module->ast __VA_OPT__(,) __VA_ARGS__); \
-        if (x ## _inst.errorsOccurred()) { m_ErrorsOccurred = true; return; }
+        if (x ## _inst.errorsOccurred()) { m_ErrorsOccurred = true; return; } }
         SW_SEMA_PIPELINE
     #undef SW_SEMA_PASS
     }
@@ -80,14 +80,10 @@ protected:
             assert(!m_NodeStack.empty());
             auto* node = m_NodeStack.back();
 
-            if (auto* expr = node->to<Expression>()) {
+            if (auto* expr = dyn_cast<Expression>(node)) {
                 if (expr->expr) {
                     const auto child_location = expr->expr->location;
-                    const bool has_location =
-                        child_location.from.Line != 0 ||
-                        child_location.from.Col != 0 ||
-                        child_location.from.Pos != 0;
-                    context.location = has_location ? child_location : node->location;
+                    context.location = child_location.isSet() ? child_location : node->location;
                 } else {
                     context.location = node->location;
                 }
@@ -133,7 +129,7 @@ protected:
     }
 
     std::string_view internString(const std::string_view str) const {
-        return m_StringPool.internLocked(str);
+        return m_StringPool.intern(str);
     }
 
 public:
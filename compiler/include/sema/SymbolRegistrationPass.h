@@ -27,10 +27,9 @@ public:
         node->parent_scope = ScopeStack.back();
 
         if (!PreCreatedScope) {
-            ScopeStack.push_back(node);
-
             if (!node->symbols)
                 node->symbols = SymMan.newScope();
+            pushScope(node);
 
             if (StructStack.back() && !StructStack.back()->scope) {
                 StructStack.back()->scope = node->symbols;
@@ -38,7 +37,7 @@ public:
             }
 
             traverse(node);
-            ScopeStack.pop_back();
+            popScope();
         } else {
             // it is assumed that the setter has pushed the scope already
             node->symbols = PreCreatedScope;
@@ -134,17 +133,16 @@ public:
             node->children = new Scope();
         }
 
-        ScopeStack.push_back(node->children);
-
         if (!node->children->symbols)
             node->children->symbols = SymMan.newScope();
+        pushScope(node->children);
 
         PreCreatedScope = node->children->symbols;
 
         registerGenericParameters(node->generic_params, node->children);
 
         traverse(node);
-        ScopeStack.pop_back();
+        popScope();
         FunctionStack.pop_back();
     }
 
@@ -156,9 +154,9 @@ public:
         SymMan.registerDecl(node->loop_var_id, entry);
 
         node->children->symbols = SymMan.newScope();
-        ScopeStack.push_back(node->children);
+        pushScope(node->children);
         traverse(node);
-        ScopeStack.pop_back();
+        popScope();
     }
 
 
@@ -243,7 +241,7 @@ public:
         ty->id = node->ident;
 
         // register all entries of the enumeration as fictitious ids
-        for (const auto id : node->entries | std::views::keys) {
+        for (const auto id : node->entries | std::views::transform(&Enum::Entry::name)) {
             const auto id_info = ty->scope->getNewIDInfo(id, true);
             SymMan.registerFictitiousID(id_info, node);
         }
@@ -279,18 +277,7 @@ public:
         if (const auto id = SymMan.getGlobalScope()->getIDInfoFor(name)) {
             assert(id.value());
             return id.value();
-        }
-
-        for (const Scope* scope : ScopeStack) {
-            if (scope) {
-                if (const auto id = scope->symbols->getIDInfoFor(name)) {
-                    assert(id.value());
-                    return id.value();
-                }
-            }
-        }
-
-        return nullptr;
+        } return SymMan.lookupLocal(name);
     }
 
     IdentInfo* getNewIDInfo(const std::string_view name) const {
@@ -298,12 +285,25 @@ public:
 
         if (const auto* scope = ScopeStack.back()) {
             assert(scope->symbols);
-            return scope->symbols->getNewIDInfo(name);
+            const auto ret = scope->symbols->getNewIDInfo(name);
+            SymMan.bindLocal(ret);
+            return ret;
         }
 
         return SymMan.getGlobalScope()->getNewIDInfo(name);
     }
 
+    /// The scope's namespace must have been set
+    void pushScope(Scope* scope) {
+        ScopeStack.push_back(scope);
+        SymMan.enterScope(scope->symbols);
+    }
+
+    void popScope() {
+        ScopeStack.pop_back();
+        SymMan.exitScope();
+    }
+
 
     bool isGlobalScope() const {
         assert(!ScopeStack.empty());
@@ -316,6 +316,8 @@ private:
         // register generic params as types and decls in the scope
         for (const auto& child : params) {
             const auto id = scope->symbols->getNewIDInfo(child->name);
+            if (scope == ScopeStack.back()) SymMan.bindLocal(id);
+
             const auto gen_type = new GenericType();
 
             SymMan.registerDecl(id, {.swirl_type = gen_type});
@@ -24,38 +24,49 @@ struct SymbolResolver : SemaVisitor<SymbolResolver> {
 
 
     void handle(const ImportNode* node, const Data&) {
-        if (!node->imported_symbols.empty()) {
-            for (auto& symbol : node->imported_symbols) {
-                IdentInfo* id = SymMan.getIdInfoFromModule(
-                    node->mod_handle, std::string(symbol.actual_name));
-
-                if (!id) {
-                    reportError(
-                        ErrCode::SYMBOL_NOT_FOUND_IN_MOD,
-                        {.path_1 = node->mod_handle->getPath(), .str_1 = symbol.actual_name}
-                        );
-                    continue;
-                }
-
-                if (!SymMan.lookupDecl(id).is_exported) {
-                    reportError(
-                        ErrCode::SYMBOL_NOT_EXPORTED,
-                        {.str_1 = symbol.actual_name}
-                        );
-                }
-
-                // make the symbol manager aware of the foreign symbol's `IdentInfo*`
-                SymMan.registerForeignID(
-                    symbol.assigned_alias.empty() ?
-                          std::string(symbol.actual_name)
-                        : std::string(symbol.assigned_alias),
-                    id, node->is_exported
-                    );
-            }
+        // wildcards are expanded here rather than by the parser, as the imported module may not have
+        // been parsed yet at that point
+        if (node->is_wildcard) {
+            ModuleMap.get(node->mod_handle).insertExportedSymbolsInto([this, node](const std::string_view name) {
+                importSymbol(node, {.actual_name = name});
+            });
+        }
+
+        for (auto& symbol : node->imported_symbols) {
+            importSymbol(node, symbol);
         }
     }
 
 
+    void importSymbol(const ImportNode* node, const ImportNode::ImportedSymbol_t& symbol) {
+        IdentInfo* id = SymMan.getIdInfoFromModule(
+            node->mod_handle, std::string(symbol.actual_name));
+
+        if (!id) {
+            reportError(
+                ErrCode::SYMBOL_NOT_FOUND_IN_MOD,
+                {.path_1 = node->mod_handle->getPath(), .str_1 = symbol.actual_name}
+                );
+            return;
+        }
+
+        if (!SymMan.lookupDecl(id).is_exported) {
+            reportError(
+                ErrCode::SYMBOL_NOT_EXPORTED,
+                {.str_1 = symbol.actual_name}
+                );
+        }
+
+        // make the symbol manager aware of the foreign symbol's `IdentInfo*`
+        SymMan.registerForeignID(
+            symbol.assigned_alias.empty() ?
+                  std::string(symbol.actual_name)
+                : std::string(symbol.assigned_alias),
+            id, node->is_exported
+            );
+    }
+
+
     void handle(const Function* node, Data data) {
         // when not being instantiated, do not attempt to resolve symbols which use generics
         if (!node->generic_params.empty() && data.generic_args.empty()) {
@@ -96,7 +107,7 @@ struct SymbolResolver : SemaVisitor<SymbolResolver> {
     void handle(FuncCall* node, Data data) {
         std::span<GenericParam*>* generic_params = nullptr;
         if (node->ident->value) {
-            auto fn_node = SymMan.lookupDecl(node->ident->value).node_ptr->to<Function>();
+            auto fn_node = cast<Function>(SymMan.lookupDecl(node->ident->value).node_ptr);
             generic_params = &fn_node->generic_params;
         }
 
@@ -153,8 +164,7 @@ struct SymbolResolver : SemaVisitor<SymbolResolver> {
             if (id.full_qualification.size() <= 1)
                 return false;
 
-            auto* first = SymMan.getIdInfoOfAGlobal(
-                std::string(id.full_qualification.front().name), false, false);
+            auto* first = SymMan.getIdInfoOfAGlobal(id.full_qualification.front().name, false, false);
             if (!first)
                 return false;
 
@@ -276,7 +276,7 @@ public:
             const auto trans_node = ComptimeEvaluator.transform(node->array_size);
             if (!ComptimeEvaluator.errorsOccurred() && trans_node != node->array_size) {
                 array_size = sw::ComptimeEvaluator::toUInt64(
-                    trans_node->to<Expression>()->expr->to<IntLit>()->value);
+                    cast<IntLit>(cast<Expression>(trans_node)->expr)->value);
             }
 
             if (arr_of_type != nullptr) {
@@ -416,7 +416,7 @@ public:
 
         auto* id = node->ident->getIdentInfo();
 
-        const auto fn_node = SymMan.lookupDecl(id).node_ptr->to<Function>();
+        const auto fn_node = cast<Function>(SymMan.lookupDecl(id).node_ptr);
         assert(fn_node);
 
         // ---  check for variadics --- //
@@ -787,7 +787,7 @@ public:
         assert(node->protocol->value);
 
         const auto target_protocol_id = node->protocol->value;
-        const auto target_protocol = SymMan.lookupDecl(target_protocol_id).node_ptr->to<Protocol>();
+        const auto target_protocol = cast<Protocol>(SymMan.lookupDecl(target_protocol_id).node_ptr);
 
         visit(target_protocol);
 
@@ -798,7 +798,7 @@ public:
         ProtocolSubstitutor::AliasMap_t alias_map;
         for (Node* member : node->children->children) {
             if (member->kind == ND_TYPE_ALIAS) {
-                const auto* alias = member->to<TypeAlias>();
+                const auto* alias = cast<TypeAlias>(member);
                 visit(alias->alias_for);
                 if (alias->alias_for && alias->alias_for->type) {
                     alias_map[alias->alias] = alias->alias_for->type;
@@ -823,13 +823,13 @@ public:
         for (Node* member : node->children->children) {
             switch (member->kind) {
                 case ND_TYPE_ALIAS: {
-                    const auto* alias = member->to<TypeAlias>();
+                    const auto* alias = cast<TypeAlias>(member);
                     type_aliases.insert(alias->alias);
                     break;
                 }
 
                 case ND_FUNC: {
-                    auto* func = member->to<Function>();
+                    auto* func = cast<Function>(member);
                     SymMan.lookupDecl(func->ident).method_of = impl_type;
                     SymMan.lookupDecl(func->ident).protocol_of = node->protocol->getIdentInfo();
 
@@ -892,7 +892,7 @@ public:
         auto protocol_ty = SymMan.lookupDecl(target_protocol_id).swirl_type->to<ProtocolConstraint>();
 
         const auto protocol_str = target_protocol_id->toString();
-        const auto report_mismatch = [this](const std::string& protocol, const std::string_view method,
+        const auto report_mismatch = [this](const std::string_view protocol, const std::string_view method,
                                             std::string&& msg, const SourceLocation loc) {
             reportError(ErrCode::PROTOCOL_METHOD_MISMATCH, {
                 .msg = std::move(msg), .str_1 = protocol, .str_2 = method, .location = loc
@@ -900,7 +900,7 @@ public:
         };
 
         const auto check_satisfied = [&](Type* expected, Type* provided,
-                                         const std::string& protocol, const std::string_view method,
+                                         const std::string_view protocol, const std::string_view method,
                                          const std::string_view what, const SourceLocation loc) {
             if (provided == expected) return;
 
@@ -1029,16 +1029,17 @@ public:
     void postVisit(Struct* node) {
         const auto ty = SymMan.lookupType(node->ident)->to<StructType>();
         ty->field_types.clear();
+        ty->is_complete = false;
 
         for (const auto& member : node->members->children) {
             if (member->getNodeType() == ND_VAR) {
-                const auto var_node = member->to<Var>();
+                const auto var_node = cast<Var>(member);
 
                 ty->field_types.push_back(var_node->var_type->type);
             }
 
             else if (member->getNodeType() == ND_FUNC) {
-                const auto fn_node = member->to<Function>();
+                const auto fn_node = cast<Function>(member);
 
                 std::vector<TypeWrapper*> param_types;
                 param_types.reserve(fn_node->params.size());
@@ -1051,6 +1052,8 @@ public:
                 GenericParameters.erase(param->name);
             }
         }
+
+        ty->is_complete = true;
     }
 
 
@@ -1079,7 +1082,7 @@ public:
     IdentInfo* expandVariadics(const FuncCall* node, std::span<Type*> types) {
         assert(node->ident && node->ident->value);
 
-        const auto fn_node = SymMan.lookupDecl(node->ident->value).node_ptr->to<Function>();
+        const auto fn_node = cast<Function>(SymMan.lookupDecl(node->ident->value).node_ptr);
         assert(fn_node != nullptr);
 
         if (const auto last_param = fn_node->params.back(); last_param->is_variadic) {
@@ -1090,7 +1093,7 @@ public:
 
             const auto new_node = VariadicExpander.transform(fn_node, ctx);
             visit(new_node);
-            return new_node->to<Function>()->ident;
+            return cast<Function>(new_node)->ident;
         } return node->ident->value;
     }
 
@@ -2,34 +2,72 @@
 #include <list>
 #include <string>
 #include <utility>
+#include <string_view>
 #include <unordered_map>
 
 #include "utils/FileSystem.h"
+#include "utils/SymbolMap.h"
+#include "utils/StringPool.h"
+#include "utils/BumpAllocator.h"
+#include "symbols/metadata.h"
 
+struct Module;
+
+
+/// Allocated in the module's arena, hence trivially destructible. The declaration the identifier names is
+/// stored inline, so that looking it up is a field access, whichever module the identifier belongs to.
 class IdentInfo {
-    std::string id;
-    sw::FileHandle* handle = nullptr;
+    std::string_view id;  // interned
+    sw::SymbolID symbol = 0;
     bool is_fictitious = false;
+    bool has_decl = false;
+
+    sw::FileHandle* handle = nullptr;
+    Module* module = nullptr;  // the one which declared it
+
+    TableEntry decl{};
+
     friend class IdentManager;
+    friend class SymbolManager;
 
 public:
     IdentInfo() = delete;
 
-    explicit IdentInfo(std::string ident, sw::FileHandle* mod_handle, const bool is_fictitious = false)
-        : id(std::move(ident))
+    explicit IdentInfo(const std::string_view ident, const sw::SymbolID symbol, Module* module,
+                       sw::FileHandle* mod_handle, const bool is_fictitious = false)
+        : id(ident)
+        , symbol(symbol)
+        , is_fictitious(is_fictitious)
         , handle(mod_handle)
-        , is_fictitious(is_fictitious) {}
+        , module(module) {}
 
     [[nodiscard]]
-    const std::string& toString() const {
+    std::string_view toString() const {
         return id;
     }
 
+    /// The pool's ID of the name
+    [[nodiscard]]
+    sw::SymbolID getSymbol() const {
+        return symbol;
+    }
+
     [[nodiscard]]
     sw::FileHandle* getModuleFileHandle() const {
         return handle;
     }
 
+    [[nodiscard]]
+    Module* getModule() const {
+        return module;
+    }
+
+    /// Set once a declaration is registered under this identifier
+    [[nodiscard]]
+    bool hasDecl() const {
+        return has_decl;
+    }
+
     [[nodiscard]]
     bool isFictitious() const {
         return is_fictitious;
@@ -37,39 +75,57 @@ public:
 };
 
 
+/// Maps the names of a namespace to their `IdentInfo`s, keyed by the names' `SymbolID`s.
 class IdentManager {
-    std::unordered_map<std::string, std::unique_ptr<IdentInfo>> m_IdentTable;
-    sw::FileHandle* m_ModuleHandle{};
+    sw::SymbolMap<IdentInfo*> m_IdentTable;
+    Module*            m_Module{};
+    sw::FileHandle*    m_ModuleHandle{};
+    sw::StringPool*    m_StringPool;
+    sw::BumpAllocator* m_Allocator;
 
     friend class SymbolManager;
 
 public:
-    explicit IdentManager(sw::FileHandle* mod_handle): m_ModuleHandle(mod_handle) {}
-
-    /// registers a new IdentInfo and returns its pointer
-    IdentInfo* createNew(const std::string& id, const bool is_fictitious = false) {
-        m_IdentTable.emplace(id, new IdentInfo(id, m_ModuleHandle, is_fictitious));
-        return m_IdentTable.at(id).get();
+    explicit IdentManager(
+        Module* module, sw::FileHandle* mod_handle, sw::StringPool& string_pool, sw::BumpAllocator& allocator)
+        : m_Module(module)
+        , m_ModuleHandle(mod_handle)
+        , m_StringPool(&string_pool)
+        , m_Allocator(&allocator) {}
+
+    /// registers a new IdentInfo and returns its pointer, or the existing one of the same name
+    IdentInfo* createNew(const std::string_view id, const bool is_fictitious = false) {
+        const auto name = m_StringPool->intern(id);
+        const auto symbol = m_StringPool->getSymbol(name);
+
+        const auto [ret, inserted] = m_IdentTable.tryEmplace(symbol);
+        if (inserted) {
+            *ret = m_Allocator->construct<IdentInfo>(name, symbol, m_Module, m_ModuleHandle, is_fictitious);
+        } return *ret;
     }
 
-    /// fetches `id`
-    IdentInfo* fetch(const std::string& id) const {
-        return m_IdentTable.at(id).get();
+    /// fetches `symbol`, returns `nullptr` if it isn't in the table
+    IdentInfo* find(const sw::SymbolID symbol) const {
+        const auto ret = m_IdentTable.find(symbol);
+        return ret ? *ret : nullptr;
     }
 
-    bool contains(const std::string& id) const {
-        return m_IdentTable.contains(id);
+    IdentInfo* find(const std::string_view id) const {
+        const auto symbol = m_StringPool->findSymbol(id);
+        return symbol ? find(*symbol) : nullptr;
     }
 
-    const sw::FileHandle* getModuleFileHandle() const {
-        return m_ModuleHandle;
+    std::size_t size() const {
+        return m_IdentTable.size();
     }
 
-    auto begin() const {
-        return m_IdentTable.begin();
+    /// Calls `fn(IdentInfo*)` for each identifier, in no particular order
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        m_IdentTable.forEach([&fn](sw::SymbolID, IdentInfo* id) { fn(id); });
     }
 
-    auto end() const  {
-        return m_IdentTable.end();
+    const sw::FileHandle* getModuleFileHandle() const {
+        return m_ModuleHandle;
     }
 };
@@ -0,0 +1,57 @@
+#pragma once
+#include <vector>
+#include <cassert>
+#include <utility>
+
+#include "utils/SymbolMap.h"
+#include "symbols/IdentManager.h"
+
+
+/// Tracks the local names visible at the current point of a traversal. Each name maps to its innermost
+/// binding, the bindings which it shadows are kept on a stack and restored once the scopes which shadowed
+/// them are exited. Resolving a name is a single probe, however deeply it is nested.
+class ScopedSymbolTable {
+public:
+    void enterScope() {
+        m_ScopeMarks.push_back(m_Shadowed.size());
+    }
+
+    /// Restores the bindings which the innermost scope shadowed
+    void exitScope() {
+        assert(!m_ScopeMarks.empty());
+        const auto mark = m_ScopeMarks.back();
+        m_ScopeMarks.pop_back();
+
+        while (m_Shadowed.size() > mark) {
+            const auto [symbol, previous] = m_Shadowed.back();
+            *m_Bindings.find(symbol) = previous;
+            m_Shadowed.pop_back();
+        }
+    }
+
+    /// Binds `id` to its name until the innermost scope is exited
+    void bind(IdentInfo* id) {
+        assert(!m_ScopeMarks.empty());
+        auto& binding = m_Bindings[id->getSymbol()];
+        if (binding == id) return;
+
+        m_Shadowed.emplace_back(id->getSymbol(), binding);
+        binding = id;
+    }
+
+    /// Returns the innermost binding of `symbol`, `nullptr` if it isn't bound
+    IdentInfo* lookup(const sw::SymbolID symbol) const {
+        const auto ret = m_Bindings.find(symbol);
+        return ret ? *ret : nullptr;
+    }
+
+    std::size_t getDepth() const {
+        return m_ScopeMarks.size();
+    }
+
+private:
+    sw::SymbolMap<IdentInfo*> m_Bindings;  // `nullptr` once a binding goes out of scope
+
+    std::vector<std::pair<sw::SymbolID, IdentInfo*>> m_Shadowed;  // the bindings each `bind` replaced
+    std::vector<std::size_t> m_ScopeMarks;  // the size of `m_Shadowed` as each scope was entered
+};
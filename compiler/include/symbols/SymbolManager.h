@@ -1,8 +1,10 @@
 #pragma once
+#include <format>
 #include <string>
 #include <ranges>
 #include <span>
 #include <utility>
+#include <stdexcept>
 #include <filesystem>
 #include <unordered_map>
 
@@ -10,7 +12,9 @@
 
 #include "types/definitions.h"
 #include "types/TypeManager.h"
+#include "types/TypeInterner.h"
 #include "symbols/IdentManager.h"
+#include "symbols/ScopedSymbolTable.h"
 #include "errors/ErrorManager.h"
 
 
@@ -23,37 +27,36 @@ class Namespace {
     IdentManager m_IDMan;
 
 public:
-    explicit Namespace(sw::FileHandle* mod_handle): m_IDMan(mod_handle) {}
+    explicit Namespace(
+        Module* module, sw::FileHandle* mod_handle, sw::StringPool& string_pool, sw::BumpAllocator& allocator)
+        : m_IDMan(module, mod_handle, string_pool, allocator) {}
 
-    IdentInfo* getNewIDInfo(const std::string& name, const bool is_fictitious = false) {
-        return m_IDMan.createNew(name, is_fictitious);
-    }
-
-    // NOTE: to be removed
     IdentInfo* getNewIDInfo(const std::string_view name, const bool is_fictitious = false) {
-        return getNewIDInfo(std::string(name), is_fictitious);
+        return m_IDMan.createNew(name, is_fictitious);
     }
 
-
-    auto begin() const {
-        return m_IDMan.begin();
+    /// The no. of identifiers declared in this namespace
+    std::size_t size() const {
+        return m_IDMan.size();
     }
 
-    auto end() const {
-        return m_IDMan.end();
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        m_IDMan.forEach(std::forward<Fn>(fn));
     }
 
     const sw::FileHandle* getModuleFileHandle() const {
         return m_IDMan.getModuleFileHandle();
     }
 
-    constexpr std::optional<IdentInfo*> getIDInfoFor(const std::string& name) const {
-        return m_IDMan.contains(name) ? std::optional{m_IDMan.fetch(name)} : std::nullopt;
+    std::optional<IdentInfo*> getIDInfoFor(const sw::SymbolID symbol) const {
+        const auto ret = m_IDMan.find(symbol);
+        return ret ? std::optional{ret} : std::nullopt;
     }
 
-    // NOTE: to be removed
-    constexpr std::optional<IdentInfo*> getIDInfoFor(const std::string_view name) const {
-        return getIDInfoFor(std::string(name));
+    std::optional<IdentInfo*> getIDInfoFor(const std::string_view name) const {
+        const auto ret = m_IDMan.find(name);
+        return ret ? std::optional{ret} : std::nullopt;
     }
 };
 
@@ -64,23 +67,28 @@ class SymbolManager {
 
     std::list<Namespace>    m_Scopes;       // for the stable-addressing of the namespaces
     std::vector<Namespace*> m_ScopeTrack;  // for tracking the insert-points
+    ScopedSymbolTable       m_LocalBindings;  // the local names visible to the ongoing traversal
 
-    std::unordered_map<IdentInfo*, TableEntry> m_IdToTableEntry;
+    std::size_t m_DeclCount = 0;  // the entries themselves are stored on the `IdentInfo`s
 
     std::filesystem::path m_ModulePath;
-    std::unordered_map<std::string, IdentInfo*> m_ImportedSymIDTable;
+    std::unordered_map<sw::SymbolID, IdentInfo*> m_ImportedSymIDTable;
 
     // tracks the exported symbols of the mod
-    std::unordered_map<std::string, ExportedSymbolMeta_t> m_ExportedSymbolTable;
+    std::unordered_map<sw::SymbolID, ExportedSymbolMeta_t> m_ExportedSymbolTable;
 
     // maps qualifier-names to their namespace
-    std::unordered_map<std::string, Namespace*> m_QualifierTable;
+    std::unordered_map<sw::SymbolID, Namespace*> m_QualifierTable;
 
     // maps fictitious IDs to parent enum nodes
     std::unordered_map<IdentInfo*, Enum*> m_FictitiousIDTable;
 
     ErrorCallback_t m_ErrorCallback;
+    Module*         m_Module{};
     sw::FileHandle* m_ModuleHandle{};
+    sw::StringPool& m_StringPool;
+    sw::BumpAllocator& m_Allocator;  // the module's, for the IdentInfos
+    TypeInterner&      m_TypeInterner;  // shared by the modules of the compilation
 
 public:
     inline static const std::unordered_map<Intrinsic::Kind, IntrinsicDef> IntrinsicTable = {
@@ -93,29 +101,47 @@ public:
 
     static std::unordered_map<Type*, std::function<void(Namespace*, SymbolManager&)>> DefaultTypeMethods;
 
+    /// Stands in for the declarations of the enum entries
+    inline static TableEntry FictitiousTableEntry{.is_exported = true};
 
-    explicit SymbolManager(sw::FileHandle* mod_handle, ModuleManager& module_man)
+
+    explicit SymbolManager(Module* module, sw::FileHandle* mod_handle, ModuleManager& module_man,
+                           sw::StringPool& string_pool, sw::BumpAllocator& allocator, TypeInterner& type_interner)
        : m_ModuleMap(module_man)
        , m_ModulePath(mod_handle->getPath())
+       , m_Module(module)
        , m_ModuleHandle(mod_handle)
+       , m_StringPool(string_pool)
+       , m_Allocator(allocator)
+       , m_TypeInterner(type_interner)
     {
         // Create the global scope
-        m_ScopeTrack.push_back(&m_Scopes.emplace_back(mod_handle));
+        m_ScopeTrack.push_back(&m_Scopes.emplace_back(module, mod_handle, string_pool, allocator));
         // Register all built-in types in the global scope
         for (const auto &[str, type] : BuiltinTypes) {
-            const auto id = m_ScopeTrack.back()->getNewIDInfo(std::string(str));
+            const auto id = m_ScopeTrack.back()->getNewIDInfo(str);
             registerType(id, type);
         }
     }
 
 
-    TableEntry& lookupDecl(IdentInfo* id);
-    TableEntry* searchDecl(IdentInfo* id);
+    /// Throws if no declaration has been registered under `id`
+    TableEntry& lookupDecl(IdentInfo* id) {
+        if (id->isFictitious()) { return FictitiousTableEntry; }
+        if (!id->has_decl) {
+            throw std::runtime_error(std::format("SymbolManager::lookupDecl: `{}` has no declaration", id->toString()));
+        } return id->decl;
+    }
+
+    TableEntry* searchDecl(IdentInfo* id) {
+        if (id->isFictitious()) { return &FictitiousTableEntry; }
+        return id->has_decl ? &id->decl : nullptr;
+    }
 
     Type* lookupType(IdentInfo* id);
 
     /// returns the IdentInfo* of a global name from the module `mod_handle`
-    IdentInfo* getIdInfoFromModule(sw::FileHandle* mod_path, const std::string& name) const;
+    IdentInfo* getIdInfoFromModule(sw::FileHandle* mod_path, std::string_view name) const;
 
     IdentInfo* getIDInfoFor(const Ident& id, const std::optional<ErrorCallback_t>& err_callback = std::nullopt);
 
@@ -132,16 +158,26 @@ public:
 
 
     /// returns the `IdentInfo*` of a global symbol.
-    IdentInfo* getIdInfoOfAGlobal(const std::string& name, bool enforce_export = false, bool report_error = true) {
-        if (const auto id = m_Scopes.front().getIDInfoFor(name))
+    IdentInfo* getIdInfoOfAGlobal(const sw::SymbolID symbol, const bool enforce_export = false, const bool report_error = true) {
+        if (const auto id = m_Scopes.front().getIDInfoFor(symbol))
             return *id;
 
         // when this flag is true, look only in the exported ids rather than every foreign id
         if (!enforce_export) {
-            if (m_ImportedSymIDTable.contains(name))
-                return m_ImportedSymIDTable[name];
-        } else if (m_ExportedSymbolTable.contains(name))
-            return m_ExportedSymbolTable[name].id;
+            if (const auto it = m_ImportedSymIDTable.find(symbol); it != m_ImportedSymIDTable.end())
+                return it->second;
+        } else if (const auto it = m_ExportedSymbolTable.find(symbol); it != m_ExportedSymbolTable.end())
+            return it->second.id;
+
+        if (report_error) {
+            m_ErrorCallback(ErrCode::QUALIFIER_UNDEFINED, {.str_1 = m_StringPool.getString(symbol)});
+        } return nullptr;
+    }
+
+    IdentInfo* getIdInfoOfAGlobal(const std::string_view name, const bool enforce_export = false, const bool report_error = true) {
+        // a name the pool has never seen cannot have been declared
+        if (const auto symbol = m_StringPool.findSymbol(name))
+            return getIdInfoOfAGlobal(*symbol, enforce_export, report_error);
 
         if (report_error) {
             m_ErrorCallback(ErrCode::QUALIFIER_UNDEFINED, {.str_1 = name});
@@ -149,16 +185,37 @@ public:
     }
 
 
-    IdentInfo* getIDInfoFor(const std::string& id) {
-        if (const auto ret = getIdInfoOfAGlobal(id)) {
-            return ret;
+    IdentInfo* getIDInfoFor(const std::string_view id) {
+        const auto symbol = m_StringPool.findSymbol(id);
+        if (!symbol) {
+            return getIdInfoOfAGlobal(id);
         }
 
-        for (const Namespace* scope : m_ScopeTrack | std::views::reverse) {
-            if (const auto ret = scope->getIDInfoFor(id)) {
-                return *ret;
-            }
-        } return nullptr;
+        if (const auto ret = getIdInfoOfAGlobal(*symbol)) {
+            return ret;
+        } return m_LocalBindings.lookup(*symbol);
+    }
+
+
+    /// Makes the names of `scope` visible to `getIDInfoFor` and `lookupLocal` until the matching `exitScope`,
+    /// the names declared in it later on are to be passed to `bindLocal`
+    void enterScope(const Namespace* scope) {
+        m_LocalBindings.enterScope();
+        scope->forEach([this](IdentInfo* id) { m_LocalBindings.bind(id); });
+    }
+
+    void exitScope() {
+        m_LocalBindings.exitScope();
+    }
+
+    void bindLocal(IdentInfo* id) {
+        m_LocalBindings.bind(id);
+    }
+
+    /// Returns the innermost local binding of `name`, `nullptr` if there is none
+    IdentInfo* lookupLocal(const std::string_view name) {
+        const auto symbol = m_StringPool.findSymbol(name);
+        return symbol ? m_LocalBindings.lookup(*symbol) : nullptr;
     }
 
 
@@ -173,7 +230,7 @@ public:
 
 
     /// Looks up a GLOBAL type
-    Type* lookupType(const std::string& id) {
+    Type* lookupType(const std::string_view id) {
         return m_TypeManager.getFor(getIDInfoFor(id));
     }
 
@@ -186,67 +243,63 @@ public:
 
 
     /// makes the symbol manager aware of the IDs of foreign (imported) symbols
-    void registerForeignID(const std::string& name, IdentInfo* id, const bool is_exported = false) {
-        m_ImportedSymIDTable.emplace(name, id);
+    void registerForeignID(const std::string_view name, IdentInfo* id, const bool is_exported = false) {
+        const auto symbol = m_StringPool.internSymbol(name);
+        m_ImportedSymIDTable.emplace(symbol, id);
         if (is_exported)
-            registerExportedSymbol(name, {.id = id});
+            registerExportedSymbol(symbol, {.id = id});
     }
 
 
     Type* getReferenceType(Type* of_type, const bool is_mutable, const bool is_str_ref = false) {
         if (is_str_ref) {
             return getSliceType(&GlobalTypeChar, true);
-        } return m_TypeManager.getReferenceType(of_type, true);
+        } return m_TypeInterner.getReferenceType(of_type, true);
     }
 
 
     /// (of_type, is_mutable) -> &[of_type]
     Type* getSliceType(Type* of_type, const bool is_mutable) {
-        return m_TypeManager.getSliceType(of_type, true);
+        return m_TypeInterner.getSliceType(of_type, true);
     }
 
 
     Type* getArrayType(Type* of_type, const std::size_t size) {
-        return m_TypeManager.getArrayType(of_type, size);
+        return m_TypeInterner.getArrayType(of_type, size);
     }
 
 
     Type* getPointerType(Type* of_type, const bool is_mutable) {
-        return m_TypeManager.getPointerType(of_type, true);  // TODO - re-enable immutability
+        return m_TypeInterner.getPointerType(of_type, true);  // TODO - re-enable immutability
     }
 
 
     /// Used to register a declaration, if `scope_index` is passed, registers the declaration at that scope rather than
     /// the one at the top.
-    IdentInfo* registerDecl(const std::string& name, const TableEntry& entry, std::optional<std::size_t> scope_index = std::nullopt) {
+    IdentInfo* registerDecl(const std::string_view name, const TableEntry& entry, std::optional<std::size_t> scope_index = std::nullopt) {
         IdentInfo* id;
         if (scope_index.has_value())
             id = m_ScopeTrack.at(*scope_index)->getNewIDInfo(name);
         else id = m_ScopeTrack.back()->getNewIDInfo(name);
 
-        if (m_IdToTableEntry.contains(id)) {
+        if (!setDecl(id, entry)) {
             m_ErrorCallback(ErrCode::SYMBOL_ALREADY_EXISTS, {.str_1 = name});
             return nullptr;
-        } m_IdToTableEntry.insert({id, entry});
+        }
 
         if (entry.is_exported) {
-            registerExportedSymbol(name, {.id = id});
+            registerExportedSymbol(id->getSymbol(), {.id = id});
         } return id;
     }
 
 
     IdentInfo* registerDecl(IdentInfo* id, TableEntry& entry) {
-        if (m_IdToTableEntry.contains(id)) {
-            return nullptr;
-        } m_IdToTableEntry.insert({id, entry});
-        return id;
+        return setDecl(id, entry) ? id : nullptr;
     }
 
 
     void registerDecl(IdentInfo* id, const TableEntry& entry) {
-        if (m_IdToTableEntry.contains(id))
-            return;
-        m_IdToTableEntry.insert({id, entry});
+        setDecl(id, entry);
     }
 
 
@@ -269,13 +322,13 @@ public:
     }
 
 
-    bool declExists(IdentInfo* id) const {
-        return m_IdToTableEntry.contains(id);
+    bool declExists(const IdentInfo* id) const {
+        return id->has_decl;
     }
 
 
     Namespace* newScope() {
-        Namespace* ret = &m_Scopes.emplace_back(m_ModuleHandle);
+        Namespace* ret = &m_Scopes.emplace_back(m_Module, m_ModuleHandle, m_StringPool, m_Allocator);
         m_ScopeTrack.push_back(ret);
         return ret;
     }
@@ -290,8 +343,43 @@ public:
     }
 
 
+    /// The no. of entries in each table, for `--mem-report`
+    struct Stats {
+        std::size_t namespaces = 0;
+        std::size_t idents     = 0;
+        std::size_t decls      = 0;
+        std::size_t imported   = 0;
+        std::size_t exported   = 0;
+        std::size_t types      = 0;  // named and derived (pointers, arrays, ...) types
+    };
+
+    Stats getStats() const {
+        Stats ret{
+            .namespaces = m_Scopes.size(),
+            .decls      = m_DeclCount,
+            .imported   = m_ImportedSymIDTable.size(),
+            .exported   = m_ExportedSymbolTable.size(),
+            .types      = m_TypeManager.getTypeCount()
+        };
+
+        for (const Namespace& scope : m_Scopes) {
+            ret.idents += scope.size();
+        } return ret;
+    }
+
+
 private:
-    void registerExportedSymbol(const std::string& name, const ExportedSymbolMeta_t& meta) {
-        m_ExportedSymbolTable.insert(std::make_pair(name, meta));
+    /// Returns false if `id` already has a declaration, which is then kept
+    bool setDecl(IdentInfo* id, const TableEntry& entry) {
+        if (id->has_decl) return false;
+
+        id->decl = entry;
+        id->has_decl = true;
+        m_DeclCount++;
+        return true;
+    }
+
+    void registerExportedSymbol(const sw::SymbolID symbol, const ExportedSymbolMeta_t& meta) {
+        m_ExportedSymbolTable.insert(std::make_pair(symbol, meta));
     }
 };
\ No newline at end of file
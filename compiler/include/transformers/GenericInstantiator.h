@@ -5,6 +5,7 @@
 #include "sema/SymbolRegistrationPass.h"
 #include "sema/SymbolResolver.h"
 #include "ast/RecursiveVisitor.h"
+#include "utils/TimeTrace.h"
 
 
 namespace sw {
@@ -79,6 +80,7 @@ public:
 
 
     void handle(Ident* ident) {
+        TimeScope scope{"generic instantiation", m_Module->file_handle->getPath()};
         std::vector<Ident::Qualifier> tmp;
 
         for (auto& [name, generic_args, _] : ident->full_qualification) {
@@ -95,9 +97,9 @@ public:
                 inst_key.id = id;
 
                 SubstitutionMap_t subst_map;
-                std::string       subst_name = inst_key.id->toString();
+                std::string       subst_name{inst_key.id->toString()};
 
-                const GlobalNode* target = m_SymMan.lookupDecl(inst_key.id).node_ptr->to<GlobalNode>();
+                const GlobalNode* target = cast<GlobalNode>(m_SymMan.lookupDecl(inst_key.id).node_ptr);
                 assert(target != nullptr);
 
                 // early-return if args and param-size do not match
@@ -157,12 +159,12 @@ public:
                     ctx.map = subst_map;
                     ctx.substitution_name = subst_name;
 
-                    name = m_Module->getStringPool().internLocked(subst_name);
+                    name = m_Module->getStringPool().intern(subst_name);
 
                     Node* new_node = m_Substitutor.run(node, ctx);
 
                     assert(new_node->isGlobal());
-                    auto* glob_node = new_node->to<GlobalNode>();
+                    auto* glob_node = cast<GlobalNode>(new_node);
                     glob_node->is_monomorphization = true;
                     glob_node->generic_params = {};
 
@@ -25,7 +25,7 @@ public:
     Node* transform(const Function* node, SubstitutionContext& ctx) {
         const auto transformed_fn = const_cast<Node*>(transformDefault(node, ctx));
 
-        const auto new_node = makeNode<Function>(*(transformed_fn->to<Function>()));
+        const auto new_node = makeNode<Function>(*cast<Function>(transformed_fn));
 
         if (!m_IsWithinStruct) {
             new_node->name = ctx.substitution_name;
@@ -40,7 +40,7 @@ public:
         const auto transformed_struct = const_cast<Node*>(transformDefault(node, ctx));
         m_IsWithinStruct = false;
 
-        const auto new_node = makeNode<Struct>(*(transformed_struct->to<Struct>()));
+        const auto new_node = makeNode<Struct>(*cast<Struct>(transformed_struct));
         new_node->name = ctx.substitution_name;
         new_node->generic_params = {};
         return new_node;
@@ -83,17 +83,17 @@ public:
         auto* result = const_cast<Node*>(transformDefault(node, ctx));
 
         // also substitute array_size, e.g., N in [T | N]
-        if (result->to<TypeWrapper>()->array_size) {
+        if (cast<TypeWrapper>(result)->array_size) {
             auto* size_node = const_cast<Node*>(static_cast<const Node*>(
-                result->to<TypeWrapper>()->array_size));
+                cast<TypeWrapper>(result)->array_size));
             auto* new_size = run(size_node, ctx);
             if (new_size != size_node) {
                 if (result == node) {
                     // transformDefault returned original — make a copy
                     result = makeNode<TypeWrapper>(*node);
-                    result->to<TypeWrapper>()->type = nullptr;
+                    cast<TypeWrapper>(result)->type = nullptr;
                 }
-                result->to<TypeWrapper>()->array_size =
+                cast<TypeWrapper>(result)->array_size =
                     static_cast<Expression*>(new_size);
             }
         }
@@ -105,7 +105,7 @@ public:
     Node* transform(const Var* node, SubstitutionContext& ctx) {
         auto* new_node = const_cast<Node*>(transformDefault(node, ctx));
         // always reset var_ident so SymbolRegistrationPass re-registers them
-        new_node->to<Var>()->var_ident = nullptr;
+        cast<Var>(new_node)->var_ident = nullptr;
         return new_node;
     }
 
@@ -113,7 +113,7 @@ public:
     Node* transform(const Parameter* node, SubstitutionContext& ctx) {
         auto* new_node = const_cast<Node*>(transformDefault(node, ctx));
         // always reset var_ident so SymbolRegistrationPass re-registers params
-        new_node->to<Parameter>()->ident = nullptr;
+        cast<Parameter>(new_node)->ident = nullptr;
         return new_node;
     }
 
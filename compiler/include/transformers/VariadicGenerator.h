@@ -54,7 +54,7 @@ public:
 
         IdentInfo* old_id = node->ident;
 
-        std::string new_name = "__Vdic_" + node->ident->toString();
+        std::string new_name = std::format("__Vdic_{}", node->ident->toString());
         std::ranges::for_each(context.types, [&new_name](const Type* ty) {
             new_name += ty->toString();
         });
@@ -94,7 +94,7 @@ public:
         if (node->is_comptime) {
             if (node->iterable->expr->getNodeType() == ND_IDENT) {
                 // check if the iterable is the variadic parameter
-                const auto id = node->iterable->expr->to<Ident>();
+                const auto id = cast<Ident>(node->iterable->expr);
                 if (id->full_qualification.front().name == context.variadic_name) {
                     // begin unrolling the loop
                     Scope unrolled_loop;
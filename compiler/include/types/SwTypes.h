@@ -217,6 +217,8 @@ struct StructType final : Type {
     std::vector<Type*> field_types;
     std::unordered_map<const char*, std::size_t> field_offsets;
 
+    bool is_complete = false;  // the fields are resolved, see `TypeResolver::postVisit(Struct*)`
+
     StructType(): Type(STRUCT) {}
 
     SwTypes getTypeTag() override { return STRUCT; }
@@ -313,7 +315,7 @@ struct GenericType final : Type {
     [[nodiscard]]
     std::string toString() const override {
         assert(id != nullptr);
-        return contained_type ? contained_type->toString() : id->toString();
+        return contained_type ? contained_type->toString() : std::string(id->toString());
     }
 
     [[nodiscard]]
@@ -357,7 +359,7 @@ struct ProtocolConstraint final : Type {
     [[nodiscard]]
     std::string toString() const override {
         assert(id != nullptr);
-        return "protocol " + id->toString();
+        return std::format("protocol {}", id->toString());
     }
 };
 
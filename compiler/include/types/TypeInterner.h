@@ -0,0 +1,123 @@
+#pragma once
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "SwTypes.h"
+
+
+/// Factory of the structural types (pointers, arrays, references and slices), shared by all the modules of a
+/// compilation, thread-safe. Each structural type is created once per compilation, hence two of them are the
+/// same type iff they are the same pointer, whichever modules asked for them.
+///
+/// The keys point to the named types owned by the modules, so an interner must not outlive the modules which
+/// use it, `ModuleManager` owns the one of its modules.
+///
+/// The types are split across shards by their hash, lookups of types which already exist take a shared lock only.
+class TypeInterner {
+public:
+    static constexpr std::size_t ShardCount = 16;
+
+    TypeInterner() = default;
+    TypeInterner(const TypeInterner&) = delete;
+    TypeInterner& operator=(const TypeInterner&) = delete;
+
+
+    /// returns a pointer for the type `to`
+    Type* getPointerType(Type* to, const bool is_mutable) {
+        return intern({Type::POINTER, to, 0, is_mutable}, [&] {
+            return std::make_unique<PointerType>(to, is_mutable);
+        });
+    }
+
+    /// returns the corresponding array-type for the type and size
+    Type* getArrayType(Type* of_type, const std::size_t size) {
+        return intern({Type::ARRAY, of_type, size, false}, [&] {
+            return std::make_unique<ArrayType>(of_type, size);
+        });
+    }
+
+    /// returns a reference for the type `to`, a slice if `to` is an array
+    Type* getReferenceType(Type* to, const bool is_mutable) {
+        if (to->getTypeTag() == Type::ARRAY)
+            return getSliceType(to->getWrappedType(), is_mutable);
+
+        if (to->getTypeTag() == Type::REFERENCE && to->is_mutable == is_mutable)
+            return to;  // reference collapsing, & + & = &
+
+        return intern({Type::REFERENCE, to, 0, is_mutable}, [&] {
+            auto ret = std::make_unique<ReferenceType>(to);
+            ret->is_mutable = is_mutable;
+            return ret;
+        });
+    }
+
+    /// returns the slice type for the given type, note that the type is supposed to be what's within
+    /// the array: &[type]
+    Type* getSliceType(Type* of_type, const bool is_mutable) {
+        return intern({Type::SLICE, of_type, 0, is_mutable}, [&] {
+            auto ret = std::make_unique<SliceType>(of_type);
+            ret->is_mutable = is_mutable;
+            return ret;
+        });
+    }
+
+
+    /// The no. of types created so far
+    std::size_t size() const {
+        return m_Count.load(std::memory_order_relaxed);
+    }
+
+
+private:
+    struct Key {
+        Type::SwTypes kind;
+        Type*         of_type;
+        std::size_t   size;
+        bool          is_mutable;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const noexcept {
+            auto ret = reinterpret_cast<std::uintptr_t>(key.of_type) * 0x9E3779B97F4A7C15ull;
+            ret ^= (key.size << 8 | static_cast<std::size_t>(key.kind) << 1 | key.is_mutable) * 0xC2B2AE3D27D4EB4Full;
+            return static_cast<std::size_t>(ret ^ ret >> 29);
+        }
+    };
+
+    struct alignas(64) Shard {
+        std::shared_mutex mutex;
+        std::unordered_map<Key, std::unique_ptr<Type>, KeyHash> types;
+    };
+
+    std::array<Shard, ShardCount> m_Shards;
+    std::atomic<std::size_t> m_Count{0};
+
+
+    /// Returns the type of `key`, creates it with `make` unless another thread has done so first
+    template <typename Fn>
+    Type* intern(const Key& key, Fn&& make) {
+        const auto hash = KeyHash{}(key);
+        // mixes the upper half of the hash in, whatever the width of `std::size_t`
+        auto& shard = m_Shards[(hash ^ hash >> (sizeof(std::size_t) * 4)) % ShardCount];
+        {
+            std::shared_lock lock(shard.mutex);
+            if (const auto it = shard.types.find(key); it != shard.types.end())
+                return it->second.get();
+        }
+
+        std::unique_lock lock(shard.mutex);
+        auto& slot = shard.types[key];
+        if (!slot) {
+            slot = make();
+            m_Count.fetch_add(1, std::memory_order_relaxed);
+        } return slot.get();
+    }
+};
+
@@ -7,29 +7,81 @@
 #include <cstddef>
 #include <cassert>
 #include <stdexcept>
+#include <type_traits>
 
 
 namespace sw {
 
 /// A BumpAllocator with stable-addressing. Not thread-safe.
+///
+/// The chunks grow geometrically, from the initial chunk size up to `Options::max_chunk_size`. Allocations
+/// above half the initial chunk size get a block of their own, so they neither fail nor retire the current
+/// chunk early.
 class BumpAllocator {
 public:
-    /// `chunk_size`: the size of each individual memory chunk in bytes
-    explicit BumpAllocator(const std::size_t chunk_size)
-        : m_ChunkSize(chunk_size)
-        , m_CurrentChunk(static_cast<Chunk*>(malloc(sizeof(Chunk) + chunk_size)))
-    {
-        if (m_CurrentChunk == nullptr)
-            throw std::bad_alloc();
-        std::construct_at(m_CurrentChunk, m_ChunkSize, nullptr);
-    }
+    /// The memory used by an allocator, in bytes unless noted otherwise
+    struct Stats {
+        std::size_t chunks    = 0;
+        std::size_t reserved  = 0;  // the capacity of all chunks
+        std::size_t allocated = 0;  // requested through `allocate`
+        std::size_t padding   = 0;  // spent on aligning the allocations
+        std::size_t tails     = 0;  // left unused at the end of the chunks which were retired
+
+        std::size_t large_objects  = 0;  // no. of allocations which got a block of their own
+        std::size_t large_reserved = 0;  // the capacity of those blocks
+        std::size_t huge_chunks    = 0;  // no. of chunks backed by hugepages
+
+        /// The bytes which can no longer be handed out
+        [[nodiscard]] std::size_t wasted() const { return padding + tails; }
+
+        Stats& operator+=(const Stats& other) {
+            chunks    += other.chunks;
+            reserved  += other.reserved;
+            allocated += other.allocated;
+            padding   += other.padding;
+            tails     += other.tails;
+
+            large_objects  += other.large_objects;
+            large_reserved += other.large_reserved;
+            huge_chunks    += other.huge_chunks;
+            return *this;
+        }
+    };
 
+    struct Options {
+        /// The cap of the chunk growth, 0 means `DefaultGrowthLimit` times the initial chunk size
+        std::size_t max_chunk_size = 0;
+
+        /// Back the chunks of at least `HugePageSize` bytes with transparent hugepages, where supported
+        bool hugepages = false;
+    };
+
+    /// The state of an allocator, see `checkpoint`
+    class Marker {
+        friend class BumpAllocator;
+
+        void*       chunk  = nullptr;
+        void*       large  = nullptr;
+        std::size_t offset = 0;
+
+        std::size_t allocated = 0;
+        std::size_t padding   = 0;
+    };
 
-    /// Allocates memory for `T` and constructs it in-place, returns the pointer to the memory.
+    static constexpr std::size_t DefaultGrowthLimit = 64;
+    static constexpr std::size_t HugePageSize = 2 * 1024 * 1024;
+
+
+    /// `chunk_size`: the size of the first memory chunk in bytes
+    explicit BumpAllocator(const std::size_t chunk_size): BumpAllocator(chunk_size, Options{}) {}
+    BumpAllocator(std::size_t chunk_size, const Options& options);
+
+
+    /// Allocates memory for `T` and constructs it in-place, returns the pointer to the memory. The
+    /// destructors are never run, hence `T` must be trivially destructible.
     template <typename T, typename... Args>
     T* construct(Args&&... args) {
-        // static_assert(std::is_trivially_destructible_v<T>);
-        assert(sizeof(T) <= m_ChunkSize);
+        static_assert(std::is_trivially_destructible_v<T>);
 
         std::byte* memory = allocate(sizeof(T), alignof(T));
         return std::construct_at(reinterpret_cast<T*>(memory), std::forward<Args>(args)...);
@@ -38,51 +90,49 @@ public:
 
     /// Returns a pointer to an aligned storage of `n` bytes
     std::byte* allocate(const std::size_t n, const std::size_t alignment = alignof(std::max_align_t)) {
-        if (n > m_ChunkSize) {
-            throw std::runtime_error(std::format
-                ("BumpAllocator::allocate: n >= m_ChunkSize ({} >= {}).",
-                    n, m_ChunkSize));
-        }
+        if (n > m_LargeThreshold)
+            return allocateLarge(n, alignment);
 
         std::byte* addr = getAlignedAddress(n, alignment);
+        if (!addr) addr = allocateInNewChunk(n, alignment);
 
-        if (!addr) {
-            // create a new chunk
-            const auto memory = malloc(sizeof(Chunk) + m_ChunkSize);
-            if (!memory) {
-                throw std::runtime_error("BumpAllocator::allocate: malloc returned null!");
-            }
-
-            auto* new_chunk = static_cast<Chunk*>(memory);
-            std::construct_at(new_chunk, m_ChunkSize, m_CurrentChunk);
+        // increment offset by n + padding size
+        const auto padding = static_cast<std::size_t>(addr - (m_CurrentChunk->data() + m_CurrentChunk->offset));
+        m_CurrentChunk->offset += n + padding;
 
-            m_CurrentChunk = new_chunk;
-            addr = getAlignedAddress(n, alignment);
+        m_Allocated += n;
+        m_Padding   += padding;
+        return addr;
+    }
 
-            if (!addr) {
-                throw std::runtime_error(
-                    "BumpAllocator::allocate: aligned address calculation failed.");
-            }
-        }
 
-        // increment offset by n + padding size
-        m_CurrentChunk->offset += n + (addr - (m_CurrentChunk->data() + m_CurrentChunk->offset));
-        return addr;
+    /// Returns the current state, which `rewind` can go back to. Meant for work which may be discarded, such as
+    /// a speculative parse, nothing in the compiler takes a checkpoint yet.
+    [[nodiscard]]
+    Marker checkpoint() const {
+        Marker ret;
+        ret.chunk  = m_CurrentChunk;
+        ret.large  = m_LargeObjects;
+        ret.offset = m_CurrentChunk->offset;
+        ret.allocated = m_Allocated;
+        ret.padding   = m_Padding;
+        return ret;
     }
 
+    /// Releases everything allocated since `marker` was taken, which invalidates the markers taken after it.
+    /// Nothing is destructed, the callers are responsible for dropping their pointers into the released memory.
+    void rewind(const Marker& marker);
+
+
+    /// Walks over the chunks, not meant for hot paths
+    [[nodiscard]]
+    Stats getStats() const;
+
 
     BumpAllocator(const BumpAllocator&) = delete;
     BumpAllocator& operator=(const BumpAllocator&) = delete;
 
-
-    ~BumpAllocator() {
-        Chunk* it = m_CurrentChunk;
-        while (it != nullptr) {
-            Chunk* prev = it->prev_chunk;
-            free(it);
-            it = prev;
-        }
-    }
+    ~BumpAllocator();
 
 
 private:
@@ -91,11 +141,13 @@ private:
         std::size_t capacity;
 
         Chunk* prev_chunk;
+        bool   is_mapped;  // by `mmap`, rather than `malloc`
 
-        Chunk(const std::size_t size, Chunk* prev_chunk)
+        Chunk(const std::size_t size, Chunk* prev_chunk, const bool is_mapped)
             : offset(0)
             , capacity(size)
-            , prev_chunk(prev_chunk) {}
+            , prev_chunk(prev_chunk)
+            , is_mapped(is_mapped) {}
 
         [[nodiscard]]
         std::byte* data() {
@@ -104,7 +156,15 @@ private:
     };
 
     const std::size_t m_ChunkSize;
+    const std::size_t m_MaxChunkSize;
+    const std::size_t m_LargeThreshold;
+    const bool        m_UseHugepages;
+
     Chunk* m_CurrentChunk;
+    Chunk* m_LargeObjects = nullptr;  // each holds a single allocation
+
+    std::size_t m_Allocated = 0;
+    std::size_t m_Padding   = 0;
 
 
     /// Returns `nullptr` if a new chunk is required to fit the data
@@ -115,5 +175,13 @@ private:
 
         return static_cast<std::byte*>(std::align(alignment, n, pointer, size_left));
     }
+
+    /// Retires the current chunk for a larger one, returns the address of `n` bytes within it
+    std::byte* allocateInNewChunk(std::size_t n, std::size_t alignment);
+    std::byte* allocateLarge(std::size_t n, std::size_t alignment);
+
+    /// Allocates a chunk able to hold at least `capacity` bytes
+    Chunk* createChunk(std::size_t capacity, Chunk* prev_chunk, bool allow_hugepages) const;
+    static void destroyChunk(Chunk* chunk);
 };
-}
\ No newline at end of file
+}
@@ -1,7 +1,8 @@
 #pragma once
 #include <string>
+#include <mutex>
+#include <vector>
 #include <memory>
-#include <optional>
 #include <filesystem>
 #include <unordered_map>
 
@@ -11,9 +12,26 @@ class FileSystem;
 class FileHandle {
 public:
     explicit FileHandle(std::string_view file_path, FileSystem* fs);
+    FileHandle(std::string_view file_path, FileSystem* fs, std::string content);
 
+    FileHandle(const FileHandle&) = delete;
+    FileHandle& operator=(const FileHandle&) = delete;
+    ~FileHandle();
+
+    /// Returns the contents of the file, which is memory-mapped (or read, as a fallback) on the first call.
+    /// Unless empty, the contents always end in a newline. The view lives as long as the handle.
     std::string_view readAll();
-    std::unique_ptr<std::istream> getStream();
+
+    struct LineColumn {
+        std::size_t line   = 1;
+        std::size_t column = 1;
+    };
+
+    /// Returns the given (1-based) line including its newline, the line-table is built on the first call
+    std::string_view getLine(std::size_t line);
+
+    /// Returns the (1-based) line and column of the char at `offset`, through the line-table
+    LineColumn getLineColumn(std::size_t offset);
 
     const std::filesystem::path& getPath();
 
@@ -22,9 +40,21 @@ public:
 
 private:
     std::filesystem::path m_Path;
-    std::optional<std::string> m_FileContent;
     FileSystem* m_FileSystem = nullptr;
 
+    std::string_view m_Content;
+    std::string      m_OwnedContent;  // for virtual files and files which couldn't be mapped
+    void*            m_Mapping = nullptr;
+    std::size_t      m_MappingSize = 0;
+    std::once_flag   m_LoadFlag;
+
+    std::vector<std::size_t> m_LineOffsets;  // (line no. - 1) : its starting pos
+    std::once_flag   m_LineOffsetsFlag;
+
+    void load();
+    void setOwnedContent(std::string content);
+    const std::vector<std::size_t>& getLineOffsets();
+
     friend class FileSystem;
 };
 
@@ -39,5 +69,6 @@ public:
 
 private:
     std::unordered_map<std::filesystem::path, std::unique_ptr<FileHandle>> m_FileTable;
+    std::mutex m_Mutex;  // files are opened by concurrent parsers
 };
 }
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <filesystem>
+
+
+namespace sw {
+
+/// Returns the no. of CPUs the process can actually make use of, i.e. the minimum of the hardware
+/// concurrency, the CPUs in the affinity mask and the cgroup (v2) `cpu.max` quota. Never returns 0.
+unsigned getAvailableParallelism();
+
+/// Returns the memory available to the process in bytes, i.e. the minimum of the physical memory and
+/// the cgroup (v2) `memory.max` limit, or 0 if it cannot be determined.
+std::uint64_t getAvailableMemory();
+
+/// Returns the no. of CPUs the quota in a cgroup (v2) `cpu.max` file amounts to, rounded up, or
+/// `std::nullopt` if the file is missing, unlimited (`max`) or malformed.
+std::optional<unsigned> readCPUMax(const std::filesystem::path& path);
+
+
+/// The no. of workers allotted to the stages of the pipeline.
+struct StageParallelism {
+    /// Parsing, sema and IR-generation, which use every worker: their tasks are CPU-bound and hold
+    /// little beyond a single module's AST or IR, so there is nothing to size them apart by
+    unsigned frontend = 1;
+
+    /// Emission (optimization included), which is also bounded by the available memory, as each of its
+    /// tasks holds a TargetMachine and an entire optimized LLVM module
+    unsigned emit = 1;
+
+    /// Sizes the stages for a pool of `threads` workers
+    static StageParallelism fromThreadCount(unsigned threads);
+};
+}
@@ -1,7 +1,15 @@
 #pragma once
+#include <bit>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
-#include <mutex>
+#include <cassert>
+#include <optional>
+#include <shared_mutex>
 #include <unordered_set>
 
 #include "BumpAllocator.h"
@@ -9,35 +17,116 @@
 
 namespace sw {
 
-/// A trivial string pool.
+/// A dense ID of an interned string, two strings of a pool are equal iff their IDs are
+using SymbolID = std::uint32_t;
+
+
+/// A string pool, shared by all the modules, thread-safe.
+///
+/// The strings are split across shards by their hash, each with a lock and an allocator of its own, so that
+/// modules parsed in parallel rarely contend. Lookups of strings which are already interned take a shared
+/// lock only. Every string is handed a `SymbolID`, which is stored in front of its chars.
 class StringPool {
 public:
-    explicit StringPool(const std::size_t chunk_size): m_BumpAllocator(chunk_size) {}
+    static constexpr std::size_t ShardCount = 16;
+
+    /// `chunk_size`: the initial chunk size of each shard's allocator
+    explicit StringPool(std::size_t chunk_size);
+
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    ~StringPool();
+
+    struct Stats {
+        std::size_t entries = 0;
+        std::size_t bytes   = 0;  // the chars of the interned strings
+        BumpAllocator::Stats allocator;
+    };
+
 
-    /// Not thread-safe.
     std::string_view intern(const std::string_view str) {
-        if (const auto a = m_Strings.find(str); a != m_Strings.end())
-            return *a;
+        auto& shard = getShard(str);
+        {
+            std::shared_lock lock(shard.mutex);
+            if (const auto it = shard.strings.find(str); it != shard.strings.end())
+                return *it;
+        } return insert(shard, str);
+    }
 
-        const auto memory = reinterpret_cast<char*>(m_BumpAllocator.allocate(str.size()));
-        memcpy(memory, str.data(), str.size());
+    SymbolID internSymbol(const std::string_view str) {
+        return getSymbol(intern(str));
+    }
 
-        const auto ret = std::string_view{memory, str.size()};
-        m_Strings.insert(ret);
-        return ret;
+    /// Returns the ID of `str` without interning it, `std::nullopt` if the pool has never seen it
+    std::optional<SymbolID> findSymbol(const std::string_view str) {
+        auto& shard = getShard(str);
+        std::shared_lock lock(shard.mutex);
+        if (const auto it = shard.strings.find(str); it != shard.strings.end())
+            return getSymbol(*it);
+        return std::nullopt;
     }
 
-    /// Thread safe.
-    std::string_view internLocked(const std::string_view str) {
-        auto lock = std::lock_guard(m_Mutex);
-        const auto ret = intern(str);
+    /// Returns the ID of a string returned by `intern`, without a lookup. The ID is read from the bytes in front
+    /// of `interned.data()`, hence passing any other view, even of equal chars (e.g. a `Token::value` which wasn't
+    /// interned), is UB.
+    SymbolID getSymbol(const std::string_view interned) const {
+        SymbolID ret;
+        memcpy(&ret, interned.data() - sizeof(SymbolID), sizeof(SymbolID));
+        assert(ret < size() && getString(ret).data() == interned.data() && "StringPool::getSymbol: not an interned view");
         return ret;
     }
 
+    /// Returns the string the ID was handed to
+    std::string_view getString(const SymbolID symbol) const {
+        const auto [segment, index] = locateSymbol(symbol);
+        return m_Symbols[segment].load(std::memory_order_acquire)[index];
+    }
+
+    std::size_t size() const {
+        return m_NextSymbol.load(std::memory_order_relaxed);
+    }
+
+
+    Stats getStats();
+
 
 private:
-    BumpAllocator m_BumpAllocator;
-    std::unordered_set<std::string_view> m_Strings;
-    std::mutex m_Mutex;
+    struct alignas(64) Shard {
+        std::shared_mutex mutex;
+        std::unordered_set<std::string_view> strings;
+        BumpAllocator allocator;
+        std::size_t bytes = 0;
+
+        explicit Shard(const std::size_t chunk_size): allocator(chunk_size) {}
+    };
+
+    /// The ID-to-string table grows in segments which are never moved, segment `i` holds
+    /// `FirstSegmentSize << i` entries, so that the readers need no lock
+    static constexpr std::size_t FirstSegmentSize = 1024;
+    static constexpr std::size_t SegmentCount = 23;  // enough for every 32-bit ID
+
+    std::array<std::unique_ptr<Shard>, ShardCount> m_Shards;
+
+    std::array<std::atomic<std::string_view*>, SegmentCount> m_Symbols{};
+    std::atomic<SymbolID> m_NextSymbol{0};
+    std::mutex m_SegmentsMutex;
+
+
+    Shard& getShard(const std::string_view str) const {
+        return *m_Shards[std::hash<std::string_view>{}(str) % ShardCount];
+    }
+
+    static std::pair<std::size_t, std::size_t> locateSymbol(const SymbolID symbol) {
+        const auto slot    = symbol / FirstSegmentSize + 1;
+        const auto segment = std::bit_width(slot) - 1;
+        return {segment, symbol - FirstSegmentSize * ((std::size_t{1} << segment) - 1)};
+    }
+
+    /// Interns `str` under the shard's exclusive lock, unless another thread has done so first
+    std::string_view insert(Shard& shard, std::string_view str);
+
+    /// Records the string of a new ID, allocates the segment it falls into if needed
+    void publishSymbol(SymbolID symbol, std::string_view str);
 };
-}
\ No newline at end of file
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include <bit>
+#include <vector>
+#include <limits>
+#include <cstdint>
+#include <utility>
+#include <cassert>
+
+#include "StringPool.h"
+
+
+namespace sw {
+
+/// An open-addressing hash map keyed by `SymbolID`s, with linear probing. The keys and values are stored
+/// inline in a single array, a lookup is a multiplication and, mostly, a single cache-line. Entries
+/// cannot be erased. Not thread-safe.
+template <typename V>
+class SymbolMap {
+public:
+    SymbolMap() = default;
+
+    /// Returns `nullptr` if `key` isn't in the map
+    V* find(const SymbolID key) {
+        if (m_Slots.empty()) return nullptr;
+
+        for (std::size_t i = getHomeSlot(key); ; i = (i + 1) & m_Mask) {
+            if (m_Slots[i].key == key) return &m_Slots[i].value;
+            if (m_Slots[i].key == EmptyKey) return nullptr;
+        }
+    }
+
+    const V* find(const SymbolID key) const {
+        return const_cast<SymbolMap*>(this)->find(key);
+    }
+
+    bool contains(const SymbolID key) const {
+        return find(key) != nullptr;
+    }
+
+    /// Inserts a value-initialized entry unless `key` is present, returns the entry and whether it was inserted
+    std::pair<V*, bool> tryEmplace(const SymbolID key) {
+        assert(key != EmptyKey);
+        std::size_t i = 0;
+        if (!m_Slots.empty()) {
+            for (i = getHomeSlot(key); m_Slots[i].key != EmptyKey; i = (i + 1) & m_Mask) {
+                if (m_Slots[i].key == key) return {&m_Slots[i].value, false};
+            }
+        }
+
+        // grows only when actually inserting, the empty slot found above is then stale
+        if ((m_Size + 1) * MaxLoadDen > m_Slots.size() * MaxLoadNum) {
+            grow();
+            i = getHomeSlot(key);
+            while (m_Slots[i].key != EmptyKey) i = (i + 1) & m_Mask;
+        }
+
+        m_Slots[i].key = key;
+        m_Size++;
+        return {&m_Slots[i].value, true};
+    }
+
+    V& operator[](const SymbolID key) {
+        return *tryEmplace(key).first;
+    }
+
+    std::size_t size() const {
+        return m_Size;
+    }
+
+    /// Calls `fn(key, value)` for each entry, in no particular order
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const auto& slot : m_Slots) {
+            if (slot.key != EmptyKey) fn(slot.key, slot.value);
+        }
+    }
+
+private:
+    static constexpr SymbolID EmptyKey = std::numeric_limits<SymbolID>::max();  // never handed out by the pool
+
+    // the max. load factor, 3/4
+    static constexpr std::size_t MaxLoadNum = 3;
+    static constexpr std::size_t MaxLoadDen = 4;
+    static constexpr std::size_t MinCapacity = 8;
+
+    struct Slot {
+        SymbolID key = EmptyKey;
+        V value{};
+    };
+
+    std::vector<Slot> m_Slots;
+    std::size_t m_Mask  = 0;
+    std::size_t m_Size  = 0;
+    int         m_Shift = 0;
+
+
+    /// The IDs are dense, hence they are scattered by a Fibonacci multiplication
+    std::size_t getHomeSlot(const SymbolID key) const {
+        return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> m_Shift) & m_Mask;
+    }
+
+    void grow() {
+        auto old_slots = std::exchange(m_Slots, std::vector<Slot>(std::max(MinCapacity, m_Slots.size() * 2)));
+        m_Mask  = m_Slots.size() - 1;
+        m_Shift = 64 - std::countr_zero(m_Slots.size());
+
+        for (auto& slot : old_slots) {
+            if (slot.key == EmptyKey) continue;
+
+            std::size_t i = getHomeSlot(slot.key);
+            while (m_Slots[i].key != EmptyKey) i = (i + 1) & m_Mask;
+            m_Slots[i] = std::move(slot);
+        }
+    }
+};
+}
@@ -1,86 +1,314 @@
 #pragma once
 #include <thread>
-#include <future>
-#include <queue>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <algorithm>
 #include <utility>
+#include <optional>
+#include <exception>
+#include <functional>
+#include <condition_variable>
 
 namespace sw {
-using u32      = uint32_t;
-using Task     = std::packaged_task<void ()>;
-using Future_t = std::future<void>;
+using u32  = uint32_t;
+using Task = std::function<void ()>;
 
-class Queue {
-    std::mutex m_Mutex;
-    std::queue<Task> m_Tasks;
-    std::condition_variable_any m_CV;
+class ThreadPool;
 
-public:
-    void push(Task task) {
-        {
-            std::unique_lock lock(m_Mutex);
-            m_Tasks.push(std::move(task));
-        }
-        m_CV.notify_one();
-    }
 
-    std::optional<Task> pop(std::stop_token tok) {
-        std::unique_lock lock(m_Mutex);
-        m_CV.wait(lock, tok, [this, tok]{ return !m_Tasks.empty() || tok.stop_requested(); });
-        if (m_Tasks.empty()) return std::nullopt;
-        auto ret = std::move(m_Tasks.front());
-        m_Tasks.pop();
-        return ret;
+/// A set of tasks which can be waited upon independently of the other tasks in the pool. Tasks of a
+/// group may enqueue further tasks into it, waiting covers those as well.
+class TaskGroup {
+    std::atomic<std::size_t> m_Pending{0};
+    std::exception_ptr m_Exception;
+    std::mutex m_ExceptionMutex;
+
+    void setException(std::exception_ptr exception) {
+        std::lock_guard lock(m_ExceptionMutex);
+        if (!m_Exception) m_Exception = std::move(exception);
     }
 
-    void notify_all() {
-        m_CV.notify_all();
+    friend class ThreadPool;
+
+public:
+    TaskGroup() = default;
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    bool isDone() const {
+        return m_Pending.load(std::memory_order_acquire) == 0;
     }
 };
 
+
+/// A work-stealing pool. Each worker owns a deque; it pushes and pops its own tasks from the back, while
+/// idle workers steal from the front of the others'. Tasks enqueued from outside the pool go through a
+/// shared injection queue. Threads which wait on a group help execute tasks instead of blocking, so
+/// waiting from within a task is fine.
 class ThreadPool {
+    struct Job {
+        Task task;
+        TaskGroup* group = nullptr;
+    };
+
+    struct Worker {
+        std::mutex      mutex;
+        std::deque<Job> jobs;
+
+        std::atomic<std::size_t>  tasks_run{0};
+        std::atomic<std::int64_t> busy_ns{0};
+        std::jthread thread;
+    };
+
 public:
+    /// Utilization figures of a single worker
+    struct WorkerStats {
+        std::size_t tasks_run = 0;
+        std::chrono::nanoseconds busy_time{};
+        std::chrono::nanoseconds lifetime{};
+
+        /// The fraction of its lifetime the worker has spent running tasks
+        double utilization() const {
+            return lifetime.count() ? static_cast<double>(busy_time.count()) / lifetime.count() : 0;
+        }
+    };
+
+    ThreadPool() = default;
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
     void setBaseThreadCount(u32 v = std::thread::hardware_concurrency()) {
         m_BaseThreadCount = v;
+        m_ActiveWorkers.store(v, std::memory_order_release);
+        m_StartTime = std::chrono::steady_clock::now();
+
+        m_Workers.reserve(v);
         for (u32 _ = 0; _ < v; ++_) {
-            m_Threads.emplace_back([this](std::stop_token tok) {
-                threadRuntime(tok);
+            m_Workers.push_back(std::make_unique<Worker>());
+        }
+
+        // the threads are only started once every worker exists, as they steal from each other
+        for (u32 i = 0; i < v; ++i) {
+            m_Workers[i]->thread = std::jthread([this, i](std::stop_token tok) {
+                threadRuntime(i, tok);
             });
         }
     }
 
-    void enqueue(std::function<void()> callable) {
+    u32 getThreadCount() const {
+        return m_BaseThreadCount.value_or(0);
+    }
+
+    /// Lets only the first `count` workers pick up tasks, the rest sleep until the limit is raised.
+    /// Used to size the stages of the pipeline individually.
+    void setActiveThreadCount(const u32 count) {
+        m_ActiveWorkers.store(std::min(count, getThreadCount()), std::memory_order_release);
+        notify(true);
+    }
+
+    /// Enqueues a task into the pool's default group, runs it inline if the pool has no threads
+    void enqueue(Task callable) {
+        enqueue(m_DefaultGroup, std::move(callable));
+    }
+
+    /// Enqueues a task into `group`, runs it inline if the pool has no threads. When called from one of
+    /// the pool's workers, the task goes to the back of the worker's own deque.
+    void enqueue(TaskGroup& group, Task callable) {
         if (!m_BaseThreadCount.has_value()) {
             callable();
             return;
         }
 
-        auto task = Task(std::move(callable));
-        m_Futures.push_back(task.get_future());
-        m_WorkPool.push(std::move(task));
+        group.m_Pending.fetch_add(1, std::memory_order_relaxed);
+        Job job{std::move(callable), &group};
+
+        // counted under the queue's lock, which `popJob` takes too, so the count never drops below zero
+        if (tl_Pool == this) {
+            std::lock_guard lock(m_Workers[tl_WorkerIndex]->mutex);
+            m_Workers[tl_WorkerIndex]->jobs.push_back(std::move(job));
+            m_QueuedJobs.fetch_add(1, std::memory_order_release);
+        } else {
+            std::lock_guard lock(m_InjectionMutex);
+            m_InjectionQueue.push_back(std::move(job));
+            m_QueuedJobs.fetch_add(1, std::memory_order_release);
+        }
+
+        notify(false);
     }
 
+    /// Blocks until all tasks of the default group have completed, rethrows the first exception
     void wait() {
-        for (auto& fut : m_Futures) fut.get();
-        m_Futures.clear();
+        wait(m_DefaultGroup);
+    }
+
+    /// Blocks until all tasks of `group` have completed (helping out meanwhile), rethrows the first
+    /// exception thrown by any of them
+    void wait(TaskGroup& group) {
+        while (!group.isDone()) {
+            if (tryRunOne()) {
+                continue;
+            }
+
+            std::unique_lock lock(m_SleepMutex);
+            m_SleepCV.wait(lock, [&] {
+                return group.isDone() || m_QueuedJobs.load(std::memory_order_acquire) > 0;
+            });
+        }
+
+        std::exception_ptr exception;
+        {
+            std::lock_guard lock(group.m_ExceptionMutex);
+            exception = std::exchange(group.m_Exception, nullptr);
+        }
+
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    /// Returns the utilization of every worker since the threads were started
+    std::vector<WorkerStats> getWorkerStats() const {
+        const auto lifetime = std::chrono::steady_clock::now() - m_StartTime;
+
+        std::vector<WorkerStats> ret;
+        ret.reserve(m_Workers.size());
+        for (const auto& worker : m_Workers) {
+            ret.push_back({
+                .tasks_run = worker->tasks_run.load(std::memory_order_relaxed),
+                .busy_time = std::chrono::nanoseconds(worker->busy_ns.load(std::memory_order_relaxed)),
+                .lifetime  = std::chrono::duration_cast<std::chrono::nanoseconds>(lifetime)
+            });
+        } return ret;
     }
 
     ~ThreadPool() {
-        for (auto& t : m_Threads) t.request_stop();
-        m_WorkPool.notify_all();
-        for (auto& t : m_Threads) if (t.joinable()) t.join();
+        for (const auto& worker : m_Workers) worker->thread.request_stop();
+        notify(true);
+        for (const auto& worker : m_Workers) if (worker->thread.joinable()) worker->thread.join();
     }
 
 private:
-    Queue                     m_WorkPool;
-    std::optional<u32>        m_BaseThreadCount;
-    std::vector<Future_t>     m_Futures;
-    std::vector<std::jthread> m_Threads;
+    std::optional<u32> m_BaseThreadCount;
+    std::vector<std::unique_ptr<Worker>> m_Workers;
+
+    std::mutex      m_InjectionMutex;
+    std::deque<Job> m_InjectionQueue;
+
+    std::atomic<std::size_t>    m_QueuedJobs{0};
+    std::atomic<u32>            m_ActiveWorkers{0};
+    std::mutex                  m_SleepMutex;
+    std::condition_variable_any m_SleepCV;     // the active workers and the waiting threads, wait for jobs
+    std::condition_variable_any m_InactiveCV;  // the workers beyond the active count, wait to be activated
+
+    TaskGroup m_DefaultGroup;
+    std::chrono::steady_clock::time_point m_StartTime;
+
+    inline static thread_local ThreadPool* tl_Pool = nullptr;
+    inline static thread_local u32 tl_WorkerIndex  = 0;
+
+    /// `all` also wakes the inactive workers, so that they re-check whether they have been activated
+    void notify(const bool all) {
+        // taking the lock orders the notification after a sleeper's predicate check
+        { std::lock_guard lock(m_SleepMutex); }
+        if (all) {
+            m_SleepCV.notify_all();
+            m_InactiveCV.notify_all();
+        } else m_SleepCV.notify_one();
+    }
+
+    std::optional<Job> popJob() {
+        const bool is_worker = tl_Pool == this;
+        const auto self = is_worker ? tl_WorkerIndex : 0;
+
+        // newest job of our own deque first, it is likely to be hot in the cache
+        if (is_worker) {
+            std::lock_guard lock(m_Workers[self]->mutex);
+            if (auto& jobs = m_Workers[self]->jobs; !jobs.empty()) {
+                auto ret = std::move(jobs.back());
+                jobs.pop_back();
+                return ret;
+            }
+        }
+
+        {
+            std::lock_guard lock(m_InjectionMutex);
+            if (!m_InjectionQueue.empty()) {
+                auto ret = std::move(m_InjectionQueue.front());
+                m_InjectionQueue.pop_front();
+                return ret;
+            }
+        }
+
+        // steal the oldest job of another worker
+        const auto count = static_cast<u32>(m_Workers.size());
+        for (u32 offset = 1; offset <= count; ++offset) {
+            const auto victim = (self + offset) % count;
+            if (is_worker && victim == self) continue;
+
+            std::lock_guard lock(m_Workers[victim]->mutex);
+            if (auto& jobs = m_Workers[victim]->jobs; !jobs.empty()) {
+                auto ret = std::move(jobs.front());
+                jobs.pop_front();
+                return ret;
+            }
+        } return std::nullopt;
+    }
+
+    bool tryRunOne() {
+        auto job = popJob();
+        if (!job) {
+            return false;
+        }
+
+        m_QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+        const auto start = std::chrono::steady_clock::now();
+
+        try {
+            job->task();
+        } catch (...) {
+            job->group->setException(std::current_exception());
+        }
+
+        if (tl_Pool == this) {
+            const auto& worker = m_Workers[tl_WorkerIndex];
+            worker->tasks_run.fetch_add(1, std::memory_order_relaxed);
+            worker->busy_ns.fetch_add(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+        }
+
+        // wake up whoever waits on the group once its last task is done
+        if (job->group->m_Pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            notify(true);
+        } return true;
+    }
+
+    void threadRuntime(const u32 index, std::stop_token tok) {
+        tl_Pool = this;
+        tl_WorkerIndex = index;
+
+        const auto is_active = [this, index] {
+            return index < m_ActiveWorkers.load(std::memory_order_acquire);
+        };
 
-    void threadRuntime(std::stop_token tok) {
         while (!tok.stop_requested()) {
-            auto taskOpt = m_WorkPool.pop(tok);
-            if (!taskOpt) break;
-            (*taskOpt)();
+            if (is_active() && tryRunOne()) {
+                continue;
+            }
+
+            // an inactive worker must not consume the single wakeups meant for the workers which can run the job
+            std::unique_lock lock(m_SleepMutex);
+            if (!is_active()) {
+                m_InactiveCV.wait(lock, tok, is_active);
+            } else {
+                m_SleepCV.wait(lock, tok, [this, &is_active] {
+                    return !is_active() || m_QueuedJobs.load(std::memory_order_acquire) > 0;
+                });
+            }
         }
     }
 };
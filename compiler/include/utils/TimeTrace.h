@@ -0,0 +1,84 @@
+#pragma once
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+
+namespace sw {
+
+/// Records how long the phases of a compilation take on each thread, for `--time-report`. The events can be
+/// written out as a Chrome trace (chrome://tracing or Perfetto) and summarized per phase, module and thread.
+/// Recording is off unless enabled, a disabled `TimeScope` costs a single relaxed load.
+///
+/// Lexing shows up as a phase of its own ("lex") only with `--pretokenize`. Otherwise the parser pulls the
+/// tokens on demand and the time spent lexing is part of "parse".
+class TimeTrace {
+public:
+    struct Event {
+        std::string_view phase;   // a string literal
+        std::string      detail;  // usually the path of the module
+        std::chrono::nanoseconds start{}, wall{}, cpu{};
+        std::uint32_t thread = 0;
+        std::uint32_t depth  = 0;  // no. of enclosing events on the same thread
+    };
+
+    /// Starts recording, the calling thread is labeled as the main one
+    static void enable();
+
+    static bool isEnabled() {
+        return Enabled.load(std::memory_order_relaxed);
+    }
+
+    static void record(Event event);
+
+    /// Writes the events in the trace-event format (JSON)
+    static void writeChromeTrace(const std::filesystem::path& path);
+
+    /// Prints the wall and CPU time spent in each phase, module and thread
+    static void printSummary();
+
+    /// Returns a small, dense ID for the calling thread
+    static std::uint32_t getThreadID();
+
+    /// Returns the CPU time consumed by the calling thread, 0 where it cannot be measured
+    static std::chrono::nanoseconds getThreadCPUTime();
+
+    static std::chrono::nanoseconds sinceStart() {
+        return std::chrono::steady_clock::now() - StartTime;
+    }
+
+private:
+    inline static std::atomic<bool> Enabled{false};
+    inline static std::chrono::steady_clock::time_point StartTime;
+
+    inline static std::mutex         EventsMutex;
+    inline static std::vector<Event> Events;
+
+    inline static std::atomic<std::uint32_t> NextThreadID{0};
+    inline static thread_local std::uint32_t tl_Depth = 0;
+
+    friend class TimeScope;
+};
+
+
+/// Records the enclosing scope as an event of `phase`, when tracing is enabled.
+class TimeScope {
+public:
+    explicit TimeScope(std::string_view phase, std::string_view detail = {});
+    TimeScope(std::string_view phase, const std::filesystem::path& detail);
+
+    TimeScope(const TimeScope&) = delete;
+    TimeScope& operator=(const TimeScope&) = delete;
+
+    ~TimeScope();
+
+private:
+    bool m_Active = false;
+    TimeTrace::Event m_Event;
+};
+}
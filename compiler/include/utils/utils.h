@@ -1,5 +1,6 @@
 #pragma once
 #include <cassert>
+#include <cstdint>
 #include <string>
 #include <thread>
 #include <condition_variable>
@@ -47,6 +48,25 @@ constexpr std::size_t hashSequence(const T& container) {
 }
 
 
+/// FNV-1a. Unlike `std::hash`, the values are stable across runs and platforms, which makes it
+/// suitable for anything persisted to disk (e.g. the build manifest).
+constexpr std::uint64_t hashStable(const std::string_view str, std::uint64_t seed = 0xcbf29ce484222325) {
+    for (const char chr : str) {
+        seed ^= static_cast<unsigned char>(chr);
+        seed *= 0x100000001b3;
+    } return seed;
+}
+
+
+constexpr std::uint64_t hashStable(std::uint64_t value, std::uint64_t seed = 0xcbf29ce484222325) {
+    for (int _ = 0; _ < 8; ++_) {
+        seed ^= value & 0xff;
+        seed *= 0x100000001b3;
+        value >>= 8;
+    } return seed;
+}
+
+
 /// A helper to define a visitor (for the very few uses of `std::visit`).
 template <typename... T>
 struct VisitorHelper: T... {
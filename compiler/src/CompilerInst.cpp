@@ -1,9 +1,15 @@
+#include <print>
+
 #include "CompilerInst.h"
 #include "backend/LLVMBackend.h"
+#include "include/SwirlConfig.h"
+#include "utils/TimeTrace.h"
 
 #include <lld/Common/Driver.h>
-#include <llvm/IR/LegacyPassManager.h>
-#include <llvm/Support/FileSystem.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
 
 #ifdef __linux__
 LLD_HAS_DRIVER(elf)
@@ -42,13 +48,164 @@ void CompilerInst::addPackageEntry(const std::string_view package, const bool is
     PackageTable[std::string(alias)] = PackageInfo{.package_root = fs::path(path)};
 }
 
+void CompilerInst::setOptimizationLevel(const std::string_view level) {
+    if (level == "0") OptimizationLevel = OptLevel::O0;
+    else if (level == "1") OptimizationLevel = OptLevel::O1;
+    else if (level == "2") OptimizationLevel = OptLevel::O2;
+    else if (level == "3") OptimizationLevel = OptLevel::O3;
+    else if (level == "s") OptimizationLevel = OptLevel::Os;
+    else throw std::runtime_error(std::format("Invalid optimization level `{}`!", level));
+}
+
+/// Returns the peak resident set size of the process in bytes, or 0 if it cannot be determined
+static std::uint64_t getPeakRSS() {
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    #ifdef __APPLE__
+        return static_cast<std::uint64_t>(usage.ru_maxrss);  // in bytes
+    #else
+        return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;  // in KiB
+    #endif
+    }
+#endif
+
+    return 0;
+}
+
+void CompilerInst::printMemoryReport() {
+    constexpr double MiB = 1024.0 * 1024.0;
+    constexpr std::size_t MaxModules = 10;
+
+    struct ModuleMemory {
+        std::string path;
+        sw::BumpAllocator::Stats allocator;
+        SymbolManager::Stats symbols;
+        std::size_t nodes = 0;
+    };
+
+    std::vector<ModuleMemory> modules;
+    sw::BumpAllocator::Stats allocators;
+    SymbolManager::Stats symbols;
+    std::array<Module::NodeStats, NodeTypeCount> nodes{};
+
+    m_ModuleManager.forEachModule([&](Module* module) {
+        auto& entry = modules.emplace_back(ModuleMemory{
+            .path = module->file_handle->getPath().string(),
+            .allocator = module->getAllocator().getStats(),
+            .symbols = module->symbol_table.getStats(),
+            .nodes = module->getNodeCount()
+        });
+
+        allocators += entry.allocator;
+        symbols.namespaces += entry.symbols.namespaces;
+        symbols.idents   += entry.symbols.idents;
+        symbols.decls    += entry.symbols.decls;
+        symbols.imported += entry.symbols.imported;
+        symbols.exported += entry.symbols.exported;
+        symbols.types    += entry.symbols.types;
+
+        for (const auto& [i, stats] : std::views::enumerate(module->getNodeStats())) {
+            nodes[i].count += stats.count;
+            nodes[i].bytes += stats.bytes;
+        }
+    });
+
+    std::ranges::sort(modules, std::greater{}, [](const ModuleMemory& entry) { return entry.allocator.reserved; });
+
+    const auto pool = m_StringPool.getStats();
+    std::println("===-------------------------------------------------------------------------===");
+    std::println("                              Memory report");
+    std::println("===-------------------------------------------------------------------------===");
+    std::println("  Peak RSS: {:.2f} MiB", getPeakRSS() / MiB);
+    std::println("  Module allocators: {} chunk(s), {:.2f} MiB reserved, {:.2f} MiB allocated, "
+                 "{:.2f} MiB wasted ({:.2f} padding + {:.2f} chunk tails)", allocators.chunks,
+        allocators.reserved / MiB, allocators.allocated / MiB, allocators.wasted() / MiB,
+        allocators.padding / MiB, allocators.tails / MiB);
+    std::println("  Large objects: {}, {:.2f} MiB reserved; hugepage-backed chunks: {}",
+        allocators.large_objects, allocators.large_reserved / MiB, allocators.huge_chunks);
+    std::println("  String pool: {} entries, {:.2f} MiB of chars, {:.2f} MiB reserved, {:.2f} MiB wasted",
+        pool.entries, pool.bytes / MiB, pool.allocator.reserved / MiB, pool.allocator.wasted() / MiB);
+    std::println("  Symbol tables: {} namespaces, {} idents, {} decls, {} imported, {} exported, {} types",
+        symbols.namespaces, symbols.idents, symbols.decls, symbols.imported, symbols.exported, symbols.types);
+    std::println("  Structural types: {} (shared by all the modules)", m_ModuleManager.getTypeInterner().size());
+
+    std::println("\n  {:<24} {:>10} {:>14}", "Node", "Count", "Bytes");
+    for (const auto& [i, stats] : std::views::enumerate(nodes)) {
+        if (stats.count) {
+            std::println("  {:<24} {:>10} {:>14}", NodeTypeNames[i], stats.count, stats.bytes);
+        }
+    }
+
+    std::println("\n  {:<40} {:>10} {:>12} {:>13} {:>8} {:>8}",
+        "Module (largest first)", "Nodes", "Alloc (KiB)", "Wasted (KiB)", "Idents", "Types");
+    for (const auto& entry : modules | std::views::take(MaxModules)) {
+        const auto name = entry.path.size() > 40
+            ? "..." + std::string(entry.path.substr(entry.path.size() - 37)) : std::string(entry.path);
+        std::println("  {:<40} {:>10} {:>12.1f} {:>13.1f} {:>8} {:>8}", name, entry.nodes,
+            entry.allocator.allocated / 1024.0, entry.allocator.wasted() / 1024.0, entry.symbols.idents,
+            entry.symbols.types);
+    }
+}
+
+void CompilerInst::computeFingerprints() {
+    m_BuildManifest.load();
+
+    // any change to the target, optimization level or the compiler itself invalidates every object
+    std::uint64_t config_hash = hashStable(Target.toString());
+    config_hash = hashStable(static_cast<std::uint64_t>(OptimizationLevel), config_hash);
+    config_hash = hashStable(std::format("{}.{}.{}", VERSION_MAJOR, VERSION_MINOR, VERSION_PATCH), config_hash);
+
+    ModuleFingerprinter fingerprinter{m_ModuleManager, config_hash};
+    std::vector<Module*> stale_modules;
+
+    m_ModuleManager.forEachModule([&](Module* module) {
+        const auto entry = fingerprinter.getEntry(module);
+
+        const auto& uid = m_ModuleManager.getModuleUID(module->file_handle->getPath());
+        module->is_up_to_date = m_BuildManifest.matches(uid, entry) && exists(getObjectPath(module));
+        module->requires_sema = !module->is_up_to_date;
+        m_Fingerprints[module] = entry;
+
+        if (!module->is_up_to_date) {
+            stale_modules.push_back(module);
+        }
+    });
+
+    // sema of a stale module needs the symbols of its dependencies, hence sema must run on them too
+    while (!stale_modules.empty()) {
+        const auto module = stale_modules.back();
+        stale_modules.pop_back();
+
+        for (Module* dep : module->dependencies) {
+            if (!dep->requires_sema) {
+                dep->requires_sema = true;
+                stale_modules.push_back(dep);
+            }
+        }
+    }
+}
+
+fs::path CompilerInst::getObjectPath(Module* module) const {
+    const auto& uid = m_ModuleManager.getModuleUID(module->file_handle->getPath());
+    return m_SrcPath.parent_path() / ".build" / "obj" / (uid + ".o");
+}
+
 void CompilerInst::startLLVMCodegen() {
     Backends_t llvm_backends;
     llvm_backends.reserve(m_ModuleManager.size());
 
     for (Module* module : m_ModuleManager) {
+        if (module->is_up_to_date) {
+            SW_LOG_INFO("Reusing the object file of {}", module->file_handle->getPath().string());
+            continue;
+        }
+
         auto* backend = llvm_backends.emplace_back(new LLVMBackend{module}).get();
-        m_ThreadPool.enqueue([backend, module] { backend->dispatch(module->ast); });
+        m_ThreadPool.enqueue([backend, module] {
+            sw::TimeScope scope{"IR gen", module->file_handle->getPath()};
+            backend->dispatch(module->ast);
+        });
     }
 
     m_ThreadPool.wait();
@@ -73,29 +230,39 @@ void CompilerInst::generateObjectFiles(Backends_t& backends) {
         create_directory(build_dir / "obj");
     }
 
-    // clear all previous object files
+    // remove the object files which don't belong to any module of this build, the linker picks up
+    // everything in the directory
+    std::unordered_set<fs::path> object_paths;
+    m_ModuleManager.forEachModule([&](Module* module) {
+        object_paths.insert(getObjectPath(module));
+    });
+
     for (const auto& entry : fs::directory_iterator(build_dir / "obj")) {
-        fs::remove(entry);
+        if (!object_paths.contains(entry.path())) {
+            fs::remove(entry);
+        }
     }
 
-    for (const auto& [counter, backend] : llvm::enumerate(backends)) {
-        llvm::legacy::PassManager pass_man;
-        std::error_code ec;
-        llvm::raw_fd_ostream dest((build_dir / "obj" / ("output_" + std::to_string(counter))).string(), ec,
-                                  llvm::sys::fs::OpenFlags::OF_None);
-
-        if (ec) {
-            throw std::runtime_error("llvm::raw_fd_ostream failed! " + ec.message());
-        }
+    // the objects are emitted concurrently, each task owning its own TargetMachine
+    m_ThreadPool.setActiveThreadCount(m_StageThreads.emit);
+    for (const auto& backend : backends) {
+        m_ThreadPool.enqueue([backend = backend.get(), obj_path = getObjectPath(backend->SwModule)] {
+            sw::TimeScope scope{"object emission", backend->SwModule->file_handle->getPath()};
+            const auto target_machine = LLVMBackend::createTargetMachine();
+            backend->optimize(target_machine.get());
+            backend->emitObjectFile(obj_path.string(), target_machine.get());
+        });
+    }
 
-        if (LLVMBackend::TargetMachine->addPassesToEmitFile(pass_man, dest, nullptr,
-                                                            llvm::CodeGenFileType::ObjectFile)) {
-            throw std::runtime_error("Target machine can't emit object file!");
-        }
+    m_ThreadPool.wait();
 
-        pass_man.run(*backend->getLLVMModule());
-        dest.flush();
+    // every object is now up-to-date, record the fingerprints for the next build
+    m_BuildManifest.clear();
+    for (const auto& [module, entry] : m_Fingerprints) {
+        m_BuildManifest.set(m_ModuleManager.getModuleUID(module->file_handle->getPath()), entry);
     }
+
+    m_BuildManifest.save();
     produceExecutable();
 }
 
@@ -237,7 +404,18 @@ void CompilerInst::produceExecutable() {
     }
 
     // do the final ritual
-    lld::lldMain(llvm_args, llvm::outs(), llvm::errs(), {platform_driver});
+    {
+        sw::TimeScope scope{"lld", OutputPath};
+        lld::lldMain(llvm_args, llvm::outs(), llvm::errs(), {platform_driver});
+    }
+
+    if (TimeReport) {
+        const auto trace_path = build_dir / "time-trace.json";
+        sw::TimeTrace::writeChromeTrace(trace_path);
+        sw::TimeTrace::printSummary();
+        std::println("Trace written to {}", trace_path.string());
+    }
+
     if (RunExe) {
         system(std::format("{}", OutputPath.string()).c_str());
     }
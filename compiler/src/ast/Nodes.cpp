@@ -176,13 +176,12 @@ void Op::setType(Type* to) const {
     if (op_type == DOT)
         return;
 
-    if (operands.front()->getNodeType() == ND_EXPR) {
-        dynamic_cast<Expression*>(operands.front())->setType(to);
+    if (const auto expr = dyn_cast<Expression>(operands.front())) {
+        expr->setType(to);
     }
 
     if (arity == 1) return;
-    if (operands.back()->getNodeType() == ND_EXPR) {
-        auto expr = dynamic_cast<Expression*>(operands.back());
+    if (const auto expr = dyn_cast<Expression>(operands.back())) {
         expr->setType(to);
         return;
     }
@@ -191,10 +190,10 @@ void Op::setType(Type* to) const {
 
 void Expression::setType(Type* to) {
     expr_type = to;
-    if (expr->getNodeType() == ND_EXPR) {
-        dynamic_cast<Expression*>(expr)->setType(to);
+    if (const auto sub_expr = dyn_cast<Expression>(expr)) {
+        sub_expr->setType(to);
     }
-    else if (expr->getNodeType() == ND_OP) {
-        dynamic_cast<Op*>(expr)->setType(to);
+    else if (const auto op = dyn_cast<Op>(expr)) {
+        op->setType(to);
     }
 }
@@ -5,9 +5,13 @@
 #include "types/SwTypes.h"
 
 #include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Module.h>
 #include <llvm/MC/TargetRegistry.h>
+#include <llvm/Passes/OptimizationLevel.h>
+#include <llvm/Passes/PassBuilder.h>
 #include <llvm/Support/CodeGen.h>
+#include <llvm/Support/FileSystem.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Target/TargetOptions.h>
@@ -68,6 +72,18 @@ LLVMBackend::LLVMBackend(Module* module)
         LLVMContext)
       }
 {
+    static std::once_flag _;
+    std::call_once(_, [] {
+        TargetMachine = createTargetMachine().release();
+    });
+
+    assert(TargetMachine);
+    LModule->setDataLayout(TargetMachine->createDataLayout());
+    LModule->setTargetTriple(llvm::Triple(CompilerInst::Target.getTriple().toString()));
+}
+
+
+std::unique_ptr<llvm::TargetMachine> LLVMBackend::createTargetMachine() {
     static std::once_flag once_flag;
     std::call_once(once_flag, []{
         llvm::InitializeNativeTarget();
@@ -86,16 +102,20 @@ LLVMBackend::LLVMBackend(Module* module)
     llvm::TargetOptions options;
     auto reloc_model = std::optional<llvm::Reloc::Model>();
 
-    static std::once_flag _;
-    std::call_once(_, [&] {
-        TargetMachine = target->createTargetMachine(
-            llvm::Triple(CompilerInst::Target.getTriple().toString()), "generic", "", options, reloc_model
-        );
-    });
+    // the codegen level of the target machine follows the IR optimization level
+    auto codegen_level = llvm::CodeGenOptLevel::None;
+    switch (CompilerInst::OptimizationLevel) {
+        case CompilerInst::OptLevel::O0: codegen_level = llvm::CodeGenOptLevel::None;       break;
+        case CompilerInst::OptLevel::O1: codegen_level = llvm::CodeGenOptLevel::Less;       break;
+        case CompilerInst::OptLevel::O2:
+        case CompilerInst::OptLevel::Os: codegen_level = llvm::CodeGenOptLevel::Default;    break;
+        case CompilerInst::OptLevel::O3: codegen_level = llvm::CodeGenOptLevel::Aggressive; break;
+    }
 
-    assert(TargetMachine);
-    LModule->setDataLayout(TargetMachine->createDataLayout());
-    LModule->setTargetTriple(llvm::Triple(CompilerInst::Target.getTriple().toString()));
+    return std::unique_ptr<llvm::TargetMachine>(target->createTargetMachine(
+        llvm::Triple(CompilerInst::Target.getTriple().toString()), "generic", "", options, reloc_model,
+        std::nullopt, codegen_level
+    ));
 }
 
 
@@ -106,11 +126,11 @@ std::string LLVMBackend::mangleString(IdentInfo* id, const ManglingContext& ctx)
         // do not mangle `extern "C"` symbols or the "main" function
         if (node->isGlobal()) {
             const bool non_mangling_condition =
-                node->to<GlobalNode>()->extern_attributes.contains("C") ||
+                cast<GlobalNode>(node)->extern_attributes.contains("C") ||
                 node->getNodeType() == ND_FUNC && !decl_lookup.method_of && id->toString() == "main";
 
             if (non_mangling_condition) {
-                return id->toString();
+                return std::string(id->toString());
             }
         }
     }
@@ -138,8 +158,54 @@ std::string LLVMBackend::mangleString(IdentInfo* id, const ManglingContext& ctx)
                       ModuleManager.getModuleUID(decl_lookup.protocol_of->getModuleFileHandle()->getPath()) + '_';
         }
 
-        return mangle + id->toString();
-    } return ret + id->toString();
+        return mangle.append(id->toString());
+    } return ret.append(id->toString());
+}
+
+
+void LLVMBackend::optimize(llvm::TargetMachine* target_machine) {
+    llvm::OptimizationLevel level;
+    switch (CompilerInst::OptimizationLevel) {
+        case CompilerInst::OptLevel::O0: return;  // nothing to be done, keep the IR as-is
+        case CompilerInst::OptLevel::O1: level = llvm::OptimizationLevel::O1; break;
+        case CompilerInst::OptLevel::O2: level = llvm::OptimizationLevel::O2; break;
+        case CompilerInst::OptLevel::O3: level = llvm::OptimizationLevel::O3; break;
+        case CompilerInst::OptLevel::Os: level = llvm::OptimizationLevel::Os; break;
+    }
+
+    llvm::LoopAnalysisManager     loop_am;
+    llvm::FunctionAnalysisManager function_am;
+    llvm::CGSCCAnalysisManager    cgscc_am;
+    llvm::ModuleAnalysisManager   module_am;
+
+    // the TargetMachine lets the pipeline use target-specific cost models (vectorization, inlining)
+    llvm::PassBuilder pass_builder{target_machine};
+    pass_builder.registerModuleAnalyses(module_am);
+    pass_builder.registerCGSCCAnalyses(cgscc_am);
+    pass_builder.registerFunctionAnalyses(function_am);
+    pass_builder.registerLoopAnalyses(loop_am);
+    pass_builder.crossRegisterProxies(loop_am, function_am, cgscc_am, module_am);
+
+    llvm::ModulePassManager module_pm = pass_builder.buildPerModuleDefaultPipeline(level);
+    module_pm.run(*LModule, module_am);
+}
+
+
+void LLVMBackend::emitObjectFile(const std::string& path, llvm::TargetMachine* target_machine) {
+    llvm::legacy::PassManager pass_man;
+    std::error_code ec;
+    llvm::raw_fd_ostream dest(path, ec, llvm::sys::fs::OpenFlags::OF_None);
+
+    if (ec) {
+        throw std::runtime_error("llvm::raw_fd_ostream failed! " + ec.message());
+    }
+
+    if (target_machine->addPassesToEmitFile(pass_man, dest, nullptr, llvm::CodeGenFileType::ObjectFile)) {
+        throw std::runtime_error("Target machine can't emit object file!");
+    }
+
+    pass_man.run(*LModule);
+    dest.flush();
 }
 
 
@@ -720,7 +786,7 @@ CGValue LLVMBackend::llvmCodegen(Op* node, SwContext context) {
             Node* receiver = node->operands.at(0);
             auto* lhs_node = node->operands.at(0)->getWrappedNodeOrInstance();
             if (lhs_node->getNodeType() == ND_OP) {
-                auto* lhs_op = lhs_node->to<Op>();
+                auto* lhs_op = cast<Op>(lhs_node);
                 if (lhs_op->op_type == Op::CAST_OP) {
                     auto* cast_target = lhs_op->operands.at(1)->getSwType();
                     if (cast_target && cast_target->getTypeTag() == Type::PROTOCOL) {
@@ -761,7 +827,7 @@ CGValue LLVMBackend::llvmCodegen(Op* node, SwContext context) {
             }
 
             assert(struct_ty != nullptr);
-            auto field_node = node->operands.at(1)->to<Ident>();
+            auto field_node = cast<Ident>(node->operands.at(1));
             auto field_ptr = Builder.CreateStructGEP(
                 codegen(struct_ty, context),
                 inst_ptr,
@@ -923,7 +989,7 @@ CGValue LLVMBackend::llvmCodegen(Ident* node, const SwContext& context) {
         const auto enum_node = SymMan.getFictitiousIDValue(node->value);
         return CGValue{nullptr, llvm::ConstantInt::get(
             codegen(enum_node->enum_type.value()->type, context),
-            enum_node->entries.at(node->full_qualification.back().name)),
+            enum_node->getValueOf(node->full_qualification.back().name)),
             enum_node->enum_type.value()->type};
     }
 
@@ -1,4 +1,5 @@
 #include <sstream>
+#include <optional>
 #include <algorithm>
 
 #include "cli/cli.h"
@@ -94,6 +95,18 @@ std::vector<Argument> cli::parse() {
                 return f1 == *arg_it || f2 == *arg_it;
             });
 
+            // short flags which take a value may have it attached, e.g. `-O2` or `-j8`
+            std::optional<std::string_view> attached_value;
+            if (flag_it == m_flags->cend()) {
+                flag_it = std::ranges::find_if(*m_flags, [&](const Argument& a) {
+                    return a.value_required && a.flags[0].size() == 2 && arg_it->size() > 2
+                        && arg_it->starts_with(a.flags[0]);
+                });
+
+                if (flag_it != m_flags->cend())
+                    attached_value = arg_it->substr(2);
+            }
+
             if (flag_it == m_flags->cend()) {
                 detail::stderr_write_line("Unknown flag: {}", *arg_it);
                 exit(1);
@@ -112,7 +125,9 @@ std::vector<Argument> cli::parse() {
                     exit(1);
                 }
                 // It's repeatable, add the new value
-                if (flag_it->value_required) {
+                if (attached_value) {
+                    supplied_it->values.emplace_back(*attached_value);
+                } else if (flag_it->value_required) {
                     if (arg_it + 1 == args.cend() || (arg_it + 1)->starts_with("-")) {
                         detail::stdout_write_line("Value missing for the flag: {}", *arg_it);
                         exit(1);
@@ -122,7 +137,9 @@ std::vector<Argument> cli::parse() {
                 }
             } else { // First time seeing this flag
                 Argument _arg = *flag_it;
-                if (_arg.value_required) {
+                if (attached_value) {
+                    _arg.values.emplace_back(*attached_value);
+                } else if (_arg.value_required) {
                     if (arg_it + 1 == args.cend() || ((arg_it + 1))->starts_with("-")) {
                         detail::stdout_write_line("Value missing for the flag: {}", *arg_it);
                         exit(1);
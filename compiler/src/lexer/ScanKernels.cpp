@@ -0,0 +1,204 @@
+#include <array>
+#include <vector>
+
+#include "lexer/ScanKernels.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define SW_SCAN_X86 1
+#endif
+
+
+namespace {
+constexpr auto IdentTable = [] {
+    std::array<bool, 256> table{};
+    for (int c = 'a'; c <= 'z'; c++) table[c] = true;
+    for (int c = 'A'; c <= 'Z'; c++) table[c] = true;
+    for (int c = '0'; c <= '9'; c++) table[c] = true;
+    table['_'] = true;
+    return table;
+}();
+
+constexpr bool isWhitespace(const char chr) {
+    return chr == ' ' || ('\t' <= chr && chr <= '\r');
+}
+
+
+const char* skipIdentScalar(const char* p, const char* end) {
+    while (p < end && IdentTable[static_cast<unsigned char>(*p)]) ++p;
+    return p;
+}
+
+const char* skipDigitsScalar(const char* p, const char* end) {
+    while (p < end && (('0' <= *p && *p <= '9') || *p == '_')) ++p;
+    return p;
+}
+
+const char* skipWhitespaceScalar(const char* p, const char* end) {
+    while (p < end && isWhitespace(*p)) ++p;
+    return p;
+}
+
+const char* findEitherScalar(const char* p, const char* end, const char a, const char b) {
+    while (p < end && *p != a && *p != b) ++p;
+    return p;
+}
+
+constexpr sw::ScanKernels ScalarKernels{
+    .name = "scalar",
+    .skipIdent = skipIdentScalar,
+    .skipDigits = skipDigitsScalar,
+    .skipWhitespace = skipWhitespaceScalar,
+    .findEither = findEitherScalar
+};
+
+
+#ifdef SW_SCAN_X86
+// ---*--- SSE4.2: PCMPESTRI matches a whole class of ranges per instruction ---*---
+
+/// Returns the index of the first byte of the 16 at `p` outside the `count` ranges in `ranges`
+template <int Count>
+__attribute__((target("sse4.2")))
+int firstOutsideRanges(const __m128i ranges, const char* p) {
+    const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    return _mm_cmpestri(ranges, Count, chunk, 16,
+        _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES | _SIDD_NEGATIVE_POLARITY | _SIDD_LEAST_SIGNIFICANT);
+}
+
+__attribute__((target("sse4.2")))
+const char* skipIdentSSE42(const char* p, const char* end) {
+    const auto ranges = _mm_setr_epi8('a', 'z', 'A', 'Z', '0', '9', '_', '_', 0, 0, 0, 0, 0, 0, 0, 0);
+    for (; end - p >= 16; p += 16) {
+        if (const int idx = firstOutsideRanges<8>(ranges, p); idx != 16) return p + idx;
+    } return skipIdentScalar(p, end);
+}
+
+__attribute__((target("sse4.2")))
+const char* skipDigitsSSE42(const char* p, const char* end) {
+    const auto ranges = _mm_setr_epi8('0', '9', '_', '_', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    for (; end - p >= 16; p += 16) {
+        if (const int idx = firstOutsideRanges<4>(ranges, p); idx != 16) return p + idx;
+    } return skipDigitsScalar(p, end);
+}
+
+__attribute__((target("sse4.2")))
+const char* skipWhitespaceSSE42(const char* p, const char* end) {
+    const auto ranges = _mm_setr_epi8('\t', '\r', ' ', ' ', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    for (; end - p >= 16; p += 16) {
+        if (const int idx = firstOutsideRanges<4>(ranges, p); idx != 16) return p + idx;
+    } return skipWhitespaceScalar(p, end);
+}
+
+__attribute__((target("sse4.2")))
+const char* findEitherSSE42(const char* p, const char* end, const char a, const char b) {
+    const auto set = _mm_setr_epi8(a, b, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+    for (; end - p >= 16; p += 16) {
+        const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const int idx = _mm_cmpestri(set, 2, chunk, 16,
+            _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT);
+        if (idx != 16) return p + idx;
+    } return findEitherScalar(p, end, a, b);
+}
+
+constexpr sw::ScanKernels SSE42Kernels{
+    .name = "sse4.2",
+    .skipIdent = skipIdentSSE42,
+    .skipDigits = skipDigitsSSE42,
+    .skipWhitespace = skipWhitespaceSSE42,
+    .findEither = findEitherSSE42
+};
+
+
+// ---*--- AVX2: classify 32 bytes through comparisons, then find the first mismatch in the mask ---*---
+
+/// Sets the bytes of `x` which lie in `[lo, hi]` (unsigned)
+__attribute__((target("avx2")))
+__m256i inRange(const __m256i x, const char lo, const char hi) {
+    const auto shifted = _mm256_sub_epi8(x, _mm256_set1_epi8(lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(static_cast<char>(hi - lo))), shifted);
+}
+
+/// Returns the index of the first byte which isn't set in `mask`, or 32
+__attribute__((target("avx2")))
+int firstUnset(const __m256i mask) {
+    const auto bits = ~static_cast<unsigned>(_mm256_movemask_epi8(mask));
+    return bits ? __builtin_ctz(bits) : 32;
+}
+
+__attribute__((target("avx2")))
+const char* skipIdentAVX2(const char* p, const char* end) {
+    for (; end - p >= 32; p += 32) {
+        const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const auto lower = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));  // folds A-Z onto a-z
+
+        const auto mask = _mm256_or_si256(
+            _mm256_or_si256(inRange(lower, 'a', 'z'), inRange(chunk, '0', '9')),
+            _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('_')));
+        if (const int idx = firstUnset(mask); idx != 32) return p + idx;
+    } return skipIdentSSE42(p, end);
+}
+
+__attribute__((target("avx2")))
+const char* skipDigitsAVX2(const char* p, const char* end) {
+    for (; end - p >= 32; p += 32) {
+        const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const auto mask = _mm256_or_si256(inRange(chunk, '0', '9'), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('_')));
+        if (const int idx = firstUnset(mask); idx != 32) return p + idx;
+    } return skipDigitsSSE42(p, end);
+}
+
+__attribute__((target("avx2")))
+const char* skipWhitespaceAVX2(const char* p, const char* end) {
+    for (; end - p >= 32; p += 32) {
+        const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const auto mask = _mm256_or_si256(inRange(chunk, '\t', '\r'), _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')));
+        if (const int idx = firstUnset(mask); idx != 32) return p + idx;
+    } return skipWhitespaceSSE42(p, end);
+}
+
+__attribute__((target("avx2")))
+const char* findEitherAVX2(const char* p, const char* end, const char a, const char b) {
+    const auto va = _mm256_set1_epi8(a), vb = _mm256_set1_epi8(b);
+    for (; end - p >= 32; p += 32) {
+        const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const auto mask = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, va), _mm256_cmpeq_epi8(chunk, vb));
+        if (const auto bits = static_cast<unsigned>(_mm256_movemask_epi8(mask))) return p + __builtin_ctz(bits);
+    } return findEitherSSE42(p, end, a, b);
+}
+
+constexpr sw::ScanKernels AVX2Kernels{
+    .name = "avx2",
+    .skipIdent = skipIdentAVX2,
+    .skipDigits = skipDigitsAVX2,
+    .skipWhitespace = skipWhitespaceAVX2,
+    .findEither = findEitherAVX2
+};
+#endif
+}
+
+
+std::span<const sw::ScanKernels* const> sw::getSupportedScanKernels() {
+    static const auto kernels = [] {
+        std::vector<const ScanKernels*> ret{&ScalarKernels};
+#ifdef SW_SCAN_X86
+        __builtin_cpu_init();
+        // the AVX2 kernels hand their tails over to the SSE4.2 ones
+        if (__builtin_cpu_supports("sse4.2")) {
+            ret.push_back(&SSE42Kernels);
+            if (__builtin_cpu_supports("avx2")) ret.push_back(&AVX2Kernels);
+        }
+#endif
+        return ret;
+    }();
+
+    return kernels;
+}
+
+const sw::ScanKernels& sw::getScanKernels() {
+    static const ScanKernels& kernels = *getSupportedScanKernels().back();
+    return kernels;
+}
+
+const sw::ScanKernels& sw::getScalarScanKernels() {
+    return ScalarKernels;
+}
@@ -0,0 +1,75 @@
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+
+#include "lexer/TokenBuffer.h"
+#include "lexer/ScanKernels.h"
+
+
+TokenBuffer::TokenBuffer(const std::string_view source): m_Source(source) {
+    if (source.size() >= std::numeric_limits<u32>::max()) {
+        throw std::runtime_error("TokenBuffer: sources of 4GiB or more can't be pre-tokenized");
+    }
+
+    // roughly one token per 4-5 bytes of source
+    const auto estimate = source.size() / 4 + 1;
+    m_Kinds.reserve(estimate);
+    m_Ids.reserve(estimate);
+    m_Offsets.reserve(estimate);
+    m_Lengths.reserve(estimate);
+    m_Ends.reserve(estimate);
+
+    const auto& kernels = sw::getScanKernels();
+    const char* const begin = source.data();
+    const char* const end   = begin + source.size();
+
+    m_LineStarts.push_back(0);
+    for (auto it = kernels.findEither(begin, end, '\n', '\n'); it != end; it = kernels.findEither(it + 1, end, '\n', '\n')) {
+        m_LineStarts.push_back(it + 1 - begin);
+    }
+}
+
+
+void TokenBuffer::push(const Token& token) {
+    const char* const data = token.value.data();
+    const bool is_view = std::greater_equal<const char*>{}(data, m_Source.data())
+        && std::less_equal<const char*>{}(data + token.value.size(), m_Source.data() + m_Source.size());
+
+    if (is_view && token.value.size() < Spilled) {
+        m_Offsets.push_back(static_cast<u32>(data - m_Source.data()));
+        m_Lengths.push_back(static_cast<u16>(token.value.size()));
+    } else {
+        m_Offsets.push_back(static_cast<u32>(m_Spilled.size()));
+        m_Lengths.push_back(Spilled);
+        m_Spilled.push_back(token.value);
+    }
+
+    m_Kinds.push_back(static_cast<std::uint8_t>(token.type));
+    m_Ids.push_back(static_cast<u16>(token.tokenid));
+    m_Ends.push_back(static_cast<u32>(token.location.Pos));
+}
+
+
+std::string_view TokenBuffer::getValue(const std::size_t i) const {
+    if (m_Lengths[i] == Spilled) {
+        return m_Spilled[m_Offsets[i]];
+    } return m_Source.substr(m_Offsets[i], m_Lengths[i]);
+}
+
+
+StreamState TokenBuffer::getLocation(const std::size_t i) const {
+    const std::size_t pos = m_Ends[i];
+    if (pos == 0) {
+        return {.Line = 1, .Pos = 0, .Col = 0};
+    }
+
+    // the (1-based) line which holds the last consumed char
+    const std::size_t line = std::ranges::upper_bound(m_LineStarts, pos - 1) - m_LineStarts.begin();
+    if (m_Source[pos - 1] != '\n') {
+        return {.Line = line, .Pos = pos, .Col = pos - m_LineStarts[line - 1]};
+    }
+
+    // a consumed newline moves the state to the next line, except for the source's final one
+    return {.Line = pos == m_Source.size() ? line : line + 1, .Pos = pos, .Col = 0};
+}
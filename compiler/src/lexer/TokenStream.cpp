@@ -3,11 +3,13 @@
 
 #include "lexer/TokenStream.h"
 #include "lexer/Tokens.h"
+#include "lexer/PerfectHash.h"
+#include "utils/TimeTrace.h"
 
 using namespace std::string_view_literals;
 
-bool TokenStream::isKeyword(const std::string& _str) {
-    return KeywordMap.contains(_str);
+bool TokenStream::isKeyword(const std::string_view _str) {
+    return KeywordTable.find(_str) != nullptr;
 }
 
 bool TokenStream::isDigit(const char chr) {
@@ -72,12 +74,13 @@ bool TokenStream::isOpChar(const char _chr) {
     return OpCharTable[static_cast<unsigned char>(_chr)];
 }
 
-std::string TokenStream::readEscaped(const char _end) const {
+/// Resolves the escape-sequences of a string/char literal's contents
+static std::string unescape(const std::string_view raw) {
     bool is_escaped = false;
     std::string ret;
+    ret.reserve(raw.size());
 
-    while (!m_Stream.eof()) {
-        const char chr = m_Stream.next();
+    for (const char chr : raw) {
         if (is_escaped) {
             switch (chr) {
                 case 'n':
@@ -115,8 +118,6 @@ std::string TokenStream::readEscaped(const char _end) const {
             is_escaped = false;
         } else if (chr == '\\')
             is_escaped = true;
-        else if (chr == _end)
-            break;
         else
             ret += chr;
     }
@@ -125,175 +126,61 @@ std::string TokenStream::readEscaped(const char _end) const {
 }
 
 
-Token TokenStream::readString(const char del) const {
-    auto str = readEscaped(del);
-    const auto type = del == '\'' ? CHAR : STRING;
-    return {type, std::move(str), getStreamState(), Token::STRING};
-}
-
-
-Token TokenStream::readOperator() const {
-    const char curr = m_Stream.getCurrentChar();
-    const char next = m_Stream.eof() ? '\0' : m_Stream.peek();
-
-    switch (curr) {
-        case '=':
-            if (next == '=') {
-                m_Stream.next();
-                return {OP, "==", getStreamState(), Token::OP_EQ};
-            }
-            return {OP, "=", getStreamState(), Token::OP_ASSIGN};
-
-        case '+':
-            if (next == '=') {
-                m_Stream.next();
-                return {OP, "+=", getStreamState(), Token::OP_PLUS_ASSIGN};
-            }
-            return {OP, "+", getStreamState(), Token::OP_PLUS};
-
-        case '-':
-            if (next == '=') {
-                m_Stream.next();
-                return {OP, "-=", getStreamState(), Token::OP_MINUS_ASSIGN};
-            }
-            return {OP, "-", getStreamState(), Token::OP_MINUS};
-
-        case '*':
-            if (next == '*') {
-                m_Stream.next();
-                if (m_Stream.peek() == '=') {
-                    m_Stream.next();
-                    return {OP, "**=", getStreamState(), Token::OP_EXP_ASSIGN};
-                }
-                return {OP, "**", getStreamState(), Token::OP_EXP};
-            }
-            if (next == '=') {
-                m_Stream.next();
-                return {OP, "*=", getStreamState(), Token::OP_MUL_ASSIGN};
-            }
-            return {OP, "*", getStreamState(), Token::OP_MUL};
-
-        case '/':
-            if (next == '=') {
-                m_Stream.next();
-                return {OP, "/=", getStreamState(), Token::OP_DIV_ASSIGN};
-            }
-            if (next == '/') {
-                if (!m_Stream.eof())
-                    m_Stream.next();
-                return {OP, "//", getStreamState(), Token::OP_COMMENT};
-            }
-            return {OP, "/", getStreamState(), Token::OP_DIV};
-
-        case '%':
-            if (next == '=') {
-                m_Stream.next();
-                return {OP, "%=", getStreamState(), Token::OP_MOD_ASSIGN};
-            }
-            return {OP, "%", getStreamState(), Token::OP_MOD};
-
-        case ':':
-            if (next == ':') {
-                m_Stream.next();
-                return {OP, "::", getStreamState(), Token::OP_SCOPE_RES};
-            }
-            return {OP, ":", getStreamState(), Token::PUNC_COLON};
-
-        case '|':
-            if (next == '|') {
-                m_Stream.next();
-                return {OP, "||", getStreamState(), Token::OP_LOGICAL_OR};
-            }
-
-            if (m_Stream.peek() == '=') {
-                m_Stream.next();
-                return {OP, "|=", getStreamState(), Token::OP_BITWISE_OR_ASSIGN};
-            }
-
-            return {OP, "|", getStreamState(), Token::OP_BITWISE_OR};
-
-        case '&':
-            if (next == '&') {
-                m_Stream.next();
-                return {OP, "&&", getStreamState(), Token::OP_LOGICAL_AND};
-            }
-
-            if (m_Stream.peek() == '=') {
-                m_Stream.next();
-                return {OP, "&=", getStreamState(), Token::OP_BITWISE_AND};
-            }
-
-            return {OP, "&", getStreamState(), Token::OP_BITWISE_AND};
+std::string_view TokenStream::readEscaped(const char _end) const {
+    const auto src  = m_Stream.getSource();
+    const auto from = m_Stream.getStreamState().Pos;
+    const char* const end = src.data() + src.size();
 
-        case '!':
-            if (next == '=') {
-                m_Stream.next();
-                return {OP, "!=", getStreamState(), Token::OP_NOT_EQ};
-            }
-            return {OP, "!", getStreamState(), Token::OP_NOT};
-
-        case '>':
-            if (next == '=') {
-                m_Stream.next();
-                return {OP, ">=", getStreamState(), Token::OP_GT_EQ};
-            }
-
-            // >>
-            if (next == '>') {
-                m_Stream.next();
-
-                // >>=
-                if (m_Stream.peek() == '=') {
-                    m_Stream.next();
-                    return {OP, ">>=", getStreamState(), Token::OP_RBITSHIFT_ASSIGN};
-                }
-
-                return {OP, ">>", getStreamState(), Token::OP_RBITSHIFT};
-            }
+    bool has_escapes = false;
+    for (const char* it = src.data() + from; (it = m_Kernels->findEither(it, end, _end, '\\')) != end; ) {
+        if (*it == '\\') {
+            has_escapes = true;
+            it = std::min(it + 2, end);
+            continue;
+        }
 
-            return {OP, ">", getStreamState(), Token::OP_GT};
+        m_Stream.advanceTo(it + 1 - src.data());
+        const auto raw = src.substr(from, it - src.data() - from);
+        return has_escapes ? m_StringPool.intern(unescape(raw)) : raw;
+    }
 
-        case '<':
-            if (next == '=') {
-                m_Stream.next();
-                return {OP, "<=", getStreamState(), Token::OP_LT_EQ};
-            }
+    // unterminated literal, it runs till the end of the source
+    m_Stream.advanceTo(src.size());
+    const auto raw = src.substr(from);
+    return has_escapes ? m_StringPool.intern(unescape(raw)) : raw;
+}
 
-            // <<
-            if (next == '<') {
-                m_Stream.next();
 
-                // <<=
-                if (m_Stream.peek() == '=') {
-                    m_Stream.next();
-                    return {OP, "<<=", getStreamState(), Token::OP_LBITSHIFT_ASSIGN};
-                }
+Token TokenStream::readString(const char del) const {
+    const auto str = readEscaped(del);
+    const auto type = del == '\'' ? CHAR : STRING;
+    return {type, str, getStreamState(), Token::STRING};
+}
 
-                return {OP, "<<", getStreamState(), Token::OP_LBITSHIFT};
-            }
 
-            return {OP, "<", getStreamState(), Token::OP_LT};
-
-        case '^':
-            if (next == '=') {
-                m_Stream.next();
-                return {OP, "^=", getStreamState(), Token::OP_XOR_ASSIGN};
-            } return {OP, "^", getStreamState(), Token::OP_XOR};
-        case '~':
-            return {OP, "~", getStreamState(), Token::OP_BITWISE_NOT};
-        case '.':
-            return {OP, ".", getStreamState(), Token::OP_DOT};
-
-        default:
-            // TODO: use swirl error manager instead of throwing rawdog exceptions
-            throw std::runtime_error(std::format("Invalid operator character: {}", curr));
+Token TokenStream::readOperator() const {
+    const auto src   = m_Stream.getSource();
+    const auto start = m_Stream.getStreamState().Pos - 1;
+
+    // maximal munch, the longest spelling which is an operator wins
+    for (auto len = std::min(OperatorTable.getMaxLength(), src.size() - start); len > 0; --len) {
+        if (const auto op = OperatorTable.find(src.substr(start, len))) {
+            m_Stream.advanceTo(start + len);
+            return {OP, src.substr(start, len), getStreamState(), op->id};
+        }
     }
+
+    // TODO: use swirl error manager instead of throwing rawdog exceptions
+    throw std::runtime_error(std::format("Invalid operator character: {}", src[start]));
 }
 
 Token TokenStream::readNextTok() {
     if (m_Stream.eof())
         return {NONE, "TOKEN:EOF", getStreamState()};
 
+    constexpr auto is_underscore = [](const char c) { return c == '_'; };
+    const auto start = m_Stream.getStreamState().Pos;
+
     switch (const char ch = m_Stream.next()) {
     case '"':
         return readString('"');
@@ -304,91 +191,103 @@ Token TokenStream::readNextTok() {
             Token op = readOperator();
             if (m_Stream.eof()) [[unlikely]]
                 return op;
-            if (op.value == ".") {
+            if (op.tokenid == Token::OP_DOT) {
                 const char next_char = m_Stream.peek();
                 if (!m_isPreviousTokIdent && isDigit(next_char) && next_char != '_')
-                    return {NUMBER, "0" + readWhile(isDigit, [](const char c) { return c == '_'; }), getStreamState(),
+                    return {NUMBER, dropIf(readRun(m_Kernels->skipDigits), is_underscore, "0"), getStreamState(),
                             Token::NUM_FLOAT};
 
                 if (next_char == '.' && !m_Stream.almostEOF() && m_Stream.peekDeeper() == '.') {
                     m_Stream.next();
                     m_Stream.next();
                     m_isPreviousTokIdent = false;
-                    return {OP, "...", getStreamState(), Token::OP_ELLIPSIS};
+                    return {OP, sourceFrom(start), getStreamState(), Token::OP_ELLIPSIS};
                 }
             }
             m_isPreviousTokIdent = false;
-            if (op.value == "//") {
-                return {COMMENT, readWhile([](const char c) { return c != '\n'; }), getStreamState(),
-                        Token::OP_COMMENT};
+            if (op.tokenid == Token::OP_COMMENT) {
+                const auto comment = readRun([this](const char* p, const char* end) {
+                    return m_Kernels->findEither(p, end, '\n', '\n');
+                });
+                return {COMMENT, comment, getStreamState(), Token::OP_COMMENT};
             }
             return op;
         }
 
         m_isPreviousTokIdent = false;
         if (isIdStart(ch)) {
-            const static std::unordered_map<std::string_view, Token::TokenValue>
-                KeywordOpMap = {
-                {"as", Token::OP_AS}, {"alignof", Token::OP_ALIGNOF},
-                {"sizeof", Token::OP_SIZEOF}, {"typeof", Token::OP_TYPEOF}
-            };
-
-            auto val = readWhile(isId);
-            if (KeywordMap.contains(val)) {
-                const Token::TokenValue kw_val = KeywordMap.at(val);
-                return {KEYWORD, std::move(val), getStreamState(), kw_val};
-            } if (KeywordOpMap.contains(val))
-                return {OP, val, getStreamState(), KeywordOpMap.at(val)};
+            const auto val = readRun(m_Kernels->skipIdent);
+            if (const auto kw = KeywordTable.find(val)) {
+                return {kw->type, val, getStreamState(), kw->id};
+            }
             m_isPreviousTokIdent = true;
-            return {IDENT, std::move(val), getStreamState(), Token::IDENT};
+            return {IDENT, val, getStreamState(), Token::IDENT};
         }
 
+        // the number-literals are views of the source, unless they contain underscores which are dropped
         if (isDigit(ch)) {
             if (m_Stream.eof())
-                return {NUMBER, std::string(1, ch), getStreamState(), Token::NUM_INT};
+                return {NUMBER, sourceFrom(start), getStreamState(), Token::NUM_INT};
             if (ch == '0') {
                 switch (m_Stream.peek()) {
                     case 'b':
                         m_Stream.next();
-                        return {NUMBER, "0" + readWhile(isBinaryDigit, [](const char c) { return c == '_'; }),
-                                getStreamState(), Token::NUM_INT};
+                        readWhile(isBinaryDigit);
+                        return {NUMBER, dropIf(sourceFrom(start), is_underscore), getStreamState(), Token::NUM_INT};
                     case 'o':
                         m_Stream.next();
-                        return {NUMBER, "0" + readWhile(isOctalDigit, [](const char c) { return c == '_'; }),
-                                getStreamState(), Token::NUM_INT};
+                        readWhile(isOctalDigit);
+                        return {NUMBER, dropIf(sourceFrom(start), is_underscore), getStreamState(), Token::NUM_INT};
                     case 'x':
                         m_Stream.next();
-                        return {NUMBER, "0" + readWhile(isHexDigit, [](const char c) { return c == '_'; }),
-                                getStreamState(), Token::NUM_INT};
+                        readWhile(isHexDigit);
+                        return {NUMBER, dropIf(sourceFrom(start), is_underscore), getStreamState(), Token::NUM_INT};
                 }
             }
-            auto val = readWhile(isDigit, [](char c) { return c == '_'; });
+            readRun(m_Kernels->skipDigits);
             if (m_Stream.eof())
-                return {NUMBER, std::move(val), getStreamState(), Token::NUM_INT};
+                return {NUMBER, dropIf(sourceFrom(start), is_underscore), getStreamState(), Token::NUM_INT};
             if (m_Stream.peek() == '.') {
                 if (m_Stream.almostEOF())
-                    return {NUMBER, std::move(val), getStreamState(), Token::NUM_INT};
+                    return {NUMBER, dropIf(sourceFrom(start), is_underscore), getStreamState(), Token::NUM_INT};
                 if (isDigit(m_Stream.peekDeeper()) && m_Stream.peekDeeper() != '_') {
                     m_Stream.next();
-                    return {NUMBER, val + readWhile(isDigit, [](const char c) { return c == '_'; }), getStreamState(),
-                            Token::NUM_FLOAT};
+                    readRun(m_Kernels->skipDigits);
+                    return {NUMBER, dropIf(sourceFrom(start), is_underscore), getStreamState(), Token::NUM_FLOAT};
                 }
             }
-            return {NUMBER, std::move(val), getStreamState(), Token::NUM_INT};
+            return {NUMBER, dropIf(sourceFrom(start), is_underscore), getStreamState(), Token::NUM_INT};
         }
 
-        return {PUNC, std::string(1, ch), getStreamState(), PuncTable.at(ch)};
+        return {PUNC, sourceFrom(start), getStreamState(), PuncTable.at(ch)};
     }
 }
 
-TokenStream::TokenStream(SourceManager& src_man) : m_Stream{src_man} {}
+TokenStream::TokenStream(SourceManager& src_man, sw::StringPool& string_pool)
+    : m_Stream{src_man}, m_StringPool{string_pool} {}
+
+void TokenStream::pretokenize() {
+    sw::TimeScope scope{"lex", m_Stream.getSourcePath()};
+    TokenBuffer buffer(m_Stream.getSource());
+
+    Token tok;
+    do {
+        tok = next(false);
+        buffer.push(tok);
+    } while (tok.type != NONE);
+
+    m_Buffer = std::move(buffer);
+    m_Index = 0;
+}
 
 void TokenStream::setReturnPoint() {
     m_Cache = m_Stream.getStreamState();
+    m_CachedIndex = m_Index;
 }
 
-void TokenStream::restoreCache() const {
+void TokenStream::restoreCache() {
     m_Stream.setStreamState(m_Cache);
+    m_Index = m_CachedIndex;
 }
 
 void TokenStream::expectTypes(std::initializer_list<TokenCategory>&& types) {
@@ -403,8 +302,8 @@ void TokenStream::expectTokens(std::initializer_list<Token>&& tokens) {
     m_Filter.expected_tokens.assign(tokens.begin(), tokens.end());
 }
 
-void TokenStream::pushback(Token tok) {
-    m_Pushback.push_back(std::move(tok));
+void TokenStream::pushback(const Token tok) {
+    m_Pushback.push_back(tok);
 }
 
 Token TokenStream::next(const bool modify_cur_tk) {
@@ -412,13 +311,19 @@ Token TokenStream::next(const bool modify_cur_tk) {
 
     // Check pushback buffer first
     if (!m_Pushback.empty()) {
-        cur_tk = std::move(m_Pushback.back());
+        cur_tk = m_Pushback.back();
         m_Pushback.pop_back();
+    } else if (isPretokenized()) {
+        // the EOF-token, which ends the buffer, is returned repeatedly
+        const auto index = std::min(m_Index, m_Buffer.size() - 1);
+        cur_tk = m_Buffer[index];
+        m_Index = index + 1;
     } else {
         unsigned char c{};
 
         // Discard junk tokens
         do {
+            skipWhitespace();
             cur_tk = readNextTok();
             if (!cur_tk.value.empty()) {
                 c = static_cast<unsigned char>(cur_tk.value[0]);
@@ -432,6 +337,17 @@ Token TokenStream::next(const bool modify_cur_tk) {
 }
 
 Token TokenStream::peek() {
+    // the pushed-back tokens come first, `next` would consume the one it returns
+    if (!m_Pushback.empty()) {
+        PeekTok = m_Pushback.back();
+        return PeekTok;
+    }
+
+    if (isPretokenized()) {
+        PeekTok = m_Buffer[std::min(m_Index, m_Buffer.size() - 1)];
+        return PeekTok;
+    }
+
     setReturnPoint();
 
     if (m_Stream.eof()) {
@@ -445,7 +361,9 @@ Token TokenStream::peek() {
 }
 
 StreamState TokenStream::getStreamState() const {
-    return m_Stream.getStreamState();
+    if (isPretokenized()) {
+        return m_Index ? m_Buffer.getLocation(m_Index - 1) : StreamState{.Line = 1};
+    } return m_Stream.getStreamState();
 }
 
 bool TokenStream::eof() const {
@@ -0,0 +1,166 @@
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+
+#include "managers/BuildManifest.h"
+#include "modules/ModuleManager.h"
+#include "utils/utils.h"
+
+
+// bump whenever the layout of the manifest changes
+static constexpr std::string_view ManifestHeader = "swirl-build-manifest 1";
+
+
+void BuildManifest::load() {
+    m_Entries.clear();
+
+    std::ifstream file(m_Path);
+    if (!file.is_open()) {
+        return;
+    }
+
+    std::string line;
+    if (!std::getline(file, line) || line != ManifestHeader) {
+        return;
+    }
+
+    // format: <module-uid> <source-hash> <deps-hash> <config-hash>
+    while (std::getline(file, line)) {
+        std::istringstream stream(line);
+        std::string uid;
+        Entry entry;
+
+        if (!(stream >> uid >> std::hex >> entry.source_hash >> entry.deps_hash >> entry.config_hash)) {
+            m_Entries.clear();
+            return;
+        } m_Entries[uid] = entry;
+    }
+}
+
+
+void BuildManifest::save() const {
+    std::ofstream file(m_Path, std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("BuildManifest::save: failed to open " + m_Path.string());
+    }
+
+    file << ManifestHeader << '\n';
+    for (const auto& [uid, entry] : m_Entries) {
+        file << uid << std::hex
+             << ' ' << entry.source_hash
+             << ' ' << entry.deps_hash
+             << ' ' << entry.config_hash << std::dec << '\n';
+    }
+}
+
+
+BuildManifest::Entry ModuleFingerprinter::getEntry(Module* module) {
+    return {
+        .source_hash = hashStable(module->file_handle->readAll()),
+        .deps_hash   = hashDependencies(module),
+        .config_hash = m_ConfigHash
+    };
+}
+
+
+std::uint64_t ModuleFingerprinter::getInterfaceHash(Module* module) {
+    if (!m_InterfaceHashes.contains(module)) {
+        visit(module);
+    } return m_InterfaceHashes.at(module);
+}
+
+
+std::uint64_t ModuleFingerprinter::hashDependencies(Module* module) {
+    std::vector<std::pair<std::string_view, std::uint64_t>> dependencies;
+    for (Module* dep : module->dependencies) {
+        dependencies.emplace_back(getUID(dep), getInterfaceHash(dep));
+    }
+
+    std::ranges::sort(dependencies);
+
+    std::uint64_t hash = hashStable(dependencies.size());
+    for (const auto& [uid, interface_hash] : dependencies) {
+        hash = hashStable(interface_hash, hashStable(uid, hash));
+    } return hash;
+}
+
+
+void ModuleFingerprinter::visit(Module* module) {
+    auto& state = m_VisitStates[module];  // the references to the entries survive rehashing
+    state = {.index = m_NextIndex, .low_link = m_NextIndex, .on_stack = true};
+    m_NextIndex++;
+    m_VisitStack.push_back(module);
+
+    for (Module* dep : module->dependencies) {
+        if (const auto it = m_VisitStates.find(dep); it == m_VisitStates.end()) {
+            visit(dep);
+            state.low_link = std::min(state.low_link, m_VisitStates.at(dep).low_link);
+        } else if (it->second.on_stack) {
+            state.low_link = std::min(state.low_link, it->second.index);
+        }
+    }
+
+    if (state.low_link != state.index) {
+        return;
+    }
+
+    // `module` is the root of a component, which consists of itself and the modules above it on the stack
+    std::vector<Module*> component;
+    Module* member;
+    do {
+        member = m_VisitStack.back();
+        m_VisitStack.pop_back();
+        m_VisitStates.at(member).on_stack = false;
+        component.push_back(member);
+    } while (member != module);
+
+    hashComponent(component);
+}
+
+
+void ModuleFingerprinter::hashComponent(std::vector<Module*>& component) {
+    std::ranges::sort(component, {}, [this](const Module* member) -> const std::string& { return getUID(member); });
+
+    // the components which this one depends upon have been hashed already
+    std::vector<std::pair<std::string_view, std::uint64_t>> dependencies;
+    std::uint64_t hash = hashStable(component.size());
+
+    for (Module* member : component) {
+        hash = hashStable(getUID(member), hash);
+
+        const auto source = member->file_handle->readAll();
+        for (Node* node : member->ast) {
+            if (!node->isGlobal() || !cast<GlobalNode>(node)->is_exported) {
+                continue;
+            }
+
+            hash = hashStable(cast<GlobalNode>(node)->name, hash);
+            if (const auto& loc = node->location; loc.length && loc.end() <= source.size()) {
+                hash = hashStable(source.substr(loc.offset, loc.length), hash);
+            }
+        }
+
+        for (Module* dep : member->dependencies) {
+            if (std::ranges::find(component, dep) == component.end()) {
+                dependencies.emplace_back(getUID(dep), m_InterfaceHashes.at(dep));
+            }
+        }
+    }
+
+    std::ranges::sort(dependencies);
+    const auto [first, last] = std::ranges::unique(dependencies);
+    dependencies.erase(first, last);
+
+    for (const auto& [uid, interface_hash] : dependencies) {
+        hash = hashStable(interface_hash, hashStable(uid, hash));
+    }
+
+    for (Module* member : component) {
+        m_InterfaceHashes[member] = hash;
+    }
+}
+
+
+const std::string& ModuleFingerprinter::getUID(const Module* module) const {
+    return m_ModuleManager.getModuleUID(module->file_handle->getPath());
+}
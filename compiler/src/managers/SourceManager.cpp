@@ -2,6 +2,7 @@
 #include <string>
 #include <fstream>
 #include <array>
+#include <cstring>
 
 #include "CompilerInst.h"
 #include "managers/SourceManager.h"
@@ -10,19 +11,8 @@
 
 
 SourceManager::SourceManager(Module* module)
-    : m_SourcePath(module->file_handle->getPath())
-    , m_LineOffsets(module->m_LineOffsets)
-{
-    std::size_t pos = 0;
-    const auto stream = std::move(module->file_handle->getStream());
-
-    for (std::string line; std::getline(*stream, line); ) {
-        line += '\n';
-        m_LineOffsets.push_back({pos, line.size()});
-        m_Source += line;
-        pos += line.size();
-    }
-}
+    : m_Source(module->file_handle->readAll())
+    , m_FileHandle(module->file_handle) {}
 
 
 char SourceManager::peek() const {
@@ -46,7 +36,6 @@ char SourceManager::next() {
 
     if (chr == '\n') {
         // line_size = 0;
-        m_CurrentLine.clear();
         if (Pos != m_Source.size()) {
             Line++;
         } Col = 0;
@@ -54,16 +43,39 @@ char SourceManager::next() {
     } else {
         // line_size++;
         Col++;
-        m_CurrentLine += chr;
     }
 
     return chr;
 }
 
 
-std::string SourceManager::getLineAt(const std::size_t line) const {
-    auto [from, line_size] = m_LineOffsets[line - 1];
-    return m_Source.substr(from, line_size);
+void SourceManager::advanceTo(const std::size_t pos) {
+    if (pos <= Pos) return;
+
+    const char* const begin = m_Source.data();
+    const char* const end   = begin + pos;
+
+    const char* it = begin + Pos;
+    while (const auto newline = static_cast<const char*>(std::memchr(it, '\n', end - it))) {
+        // the source's final newline doesn't open a new line, same as in `next()`
+        if (newline + 1 != begin + m_Source.size()) {
+            Line++;
+        } Col = 0;
+        it = newline + 1;
+    }
+
+    Col += end - it;
+    Pos  = pos;
+    m_CurrentChar = m_Source[pos - 1];
+}
+
+
+std::string_view SourceManager::getLineAt(const std::size_t line) const {
+    return m_FileHandle->getLine(line);
+}
+
+const std::filesystem::path& SourceManager::getSourcePath() const {
+    return m_FileHandle->getPath();
 }
 
 void SourceManager::reset() {
@@ -78,10 +90,6 @@ bool SourceManager::eof() const {
     return Pos == m_Source.size();
 }
 
-std::string SourceManager::getCurrentLine() const {
-    return m_CurrentLine;
-}
-
 StreamState SourceManager::getStreamState() const {
     return {.Line = Line, .Pos = Pos, .Col = Col};
 }
@@ -5,10 +5,12 @@
 #include "sema/Sema.h"
 #include "comptime/ComptimeEvaluator.h"
 #include "transformers/GenericInstantiator.h"
+#include "utils/TimeTrace.h"
 
 
 Module::Module(const ModuleContext& context)
-    : symbol_table(context.file_handle, context.module_manager)
+    : symbol_table(this, context.file_handle, context.module_manager, context.string_pool, m_Allocator,
+                   context.module_manager.getTypeInterner())
     , file_handle(context.file_handle)
     , m_ModuleManager(context.module_manager)
     , m_StringPool(context.string_pool)
@@ -16,6 +18,14 @@ Module::Module(const ModuleContext& context)
     , m_CtxCopy(context) {}
 
 
+void Module::pretokenize() {
+    SourceManager src_man{this};
+    TokenStream stream{src_man, m_StringPool};
+    stream.pretokenize();
+    m_Tokens = stream.takeTokenBuffer();
+}
+
+
 void Module::performSema(const ErrorCallback_t& error_callback) {
     if (m_IsSemaComplete) {
         return;
@@ -33,6 +43,7 @@ void Module::performSema(const ErrorCallback_t& error_callback) {
 
 
 void Module::performComptimeEval(const ErrorCallback_t& error_callback) {
+    sw::TimeScope scope{"comptime", file_handle->getPath()};
     sw::ComptimeEvaluator evaluator{this, error_callback};
     ast = evaluator.run(ast);
 
@@ -43,9 +54,7 @@ void Module::performComptimeEval(const ErrorCallback_t& error_callback) {
 }
 
 
-void Module::decrementUnresolvedDeps() {
-    unresolved_deps--;
-    if (unresolved_deps == 0) {
-        m_ModuleManager.m_BackBuffer.push_back(this);
-    }
+bool Module::resolveDependency() {
+    // acq_rel makes the writes of every dependency visible to the thread which processes this module
+    return unresolved_deps.fetch_sub(1, std::memory_order_acq_rel) == 1;
 }
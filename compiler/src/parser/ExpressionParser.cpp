@@ -35,20 +35,23 @@ Node* ExpressionParser::parseComponent() {
         }
 
         case STRING: {
-            std::string content = m_Stream.CurTok.value;
-
-            auto cur_location = m_Stream.CurTok.location;
-            cur_location.Col -= m_Stream.CurTok.value.size();
+            const auto first = m_Stream.CurTok.value;
 
+            const auto from = m_Parser.getTokenStart();
             m_Parser.forwardStream();
-            while (m_Stream.CurTok.tokenid == Token::STRING) {  // concatenate adjacent string literals
-                content += m_Stream.CurTok.value;
-                m_Parser.forwardStream();
+
+            // adjacent string literals are concatenated, a lone literal is interned as is
+            std::string content;
+            if (m_Stream.CurTok.tokenid == Token::STRING) {
+                content = first;
+                while (m_Stream.CurTok.tokenid == Token::STRING) {
+                    content += m_Stream.CurTok.value;
+                    m_Parser.forwardStream();
+                }
             }
 
-            auto str = make_node<StrLit>(internString(content));
-            str->location.from = cur_location;
-            str->location.to = m_Stream.CurTok.location;
+            auto str = make_node<StrLit>(internString(content.empty() ? first : content));
+            str->location = SourceLocation::fromRange(from, m_Parser.getTokenStart());
             return str;
         }
 
@@ -130,7 +133,7 @@ Node* ExpressionParser::parseComponent() {
 
                     if (!m_Stream.CurTok.is(Token::PUNC_COMMA, Token::PUNC_RBRACKET)) {
                         m_Parser.reportError(ErrCode::COMMA_SEP_REQUIRED,
-                            {.location = SourceLocation{m_Stream.CurTok.location}});
+                            {.location = SourceLocation::ofToken(m_Stream.CurTok)});
                         parseExpr();
                         continue;
                     }
@@ -2,9 +2,11 @@
 #include <fstream>
 #include <utility>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <optional>
 #include <functional>
+#include <algorithm>
 
 #include "utils/utils.h"
 #include "ast/Nodes.h"
@@ -24,7 +26,7 @@
 
 
 Parser::Parser(const ParserContext& context)
-    : m_Stream(m_SrcMan)
+    : m_Stream(m_SrcMan, context.string_pool)
     , m_SrcMan(context.module)
     , m_Module(context.module)
     , m_ErrorCallback(context.error_callback)
@@ -38,6 +40,12 @@ Parser::Parser(const ParserContext& context)
           [this](auto code, const auto& ctx) {
               reportError(code, ctx);
           });
+
+      // the imported modules have been lexed on the pool already (see `ModuleManager::parseAsync`)
+      if (auto tokens = m_Module->takeTokens(); !tokens.empty())
+          m_Stream.adoptTokenBuffer(std::move(tokens));
+      else if (CompilerInst::PreTokenize)
+          m_Stream.pretokenize();
     }
 
 
@@ -243,7 +251,7 @@ Node* Parser::dispatch() {
                 forwardStream();
 
                 if (m_Stream.CurTok.tokenid == Token::STRING) {
-                    m_ExternAttributes = std::move(m_Stream.CurTok.value);
+                    m_ExternAttributes = m_Stream.CurTok.value;
                     forwardStream();
                 }
 
@@ -366,8 +374,9 @@ ImportNode* Parser::parseImport() {
     fs::path mod_path;
     std::vector<ImportNode::ImportedSymbol_t> imported_symbols;
 
-    if (CompilerInst::PackageTable.contains(m_Stream.CurTok.value)) {
-        mod_path = CompilerInst::PackageTable[m_Stream.CurTok.value].package_root;
+    if (const auto package = CompilerInst::PackageTable.find(std::string(m_Stream.CurTok.value));
+        package != CompilerInst::PackageTable.end()) {
+        mod_path = package->second.package_root;
     } else reportError(ErrCode::PACKAGE_NOT_FOUND,
         {.str_1 = m_StringPool.intern(m_Stream.CurTok.value)});
 
@@ -395,18 +404,16 @@ ImportNode* Parser::parseImport() {
     const auto handle = m_FileSystem.open(mod_path);
     ret.mod_handle = handle;
 
-    if (!ModuleMap.contains(handle)) {
-        ModuleMap.insert(handle, m_Module->getModuleContext());
-        ModuleMap.get(handle).parse(m_ErrorCallback);
+    // a newly discovered module is parsed concurrently with this one, nothing here needs its AST
+    const auto [module, inserted] = ModuleMap.tryInsert(handle, m_Module->getModuleContext());
+    if (inserted) {
+        ModuleMap.parseAsync(module, m_ErrorCallback);
     }
 
-    if (m_Module->dependencies.contains(&ModuleMap.get(handle))) {
+    if (!ModuleMap.addDependency(m_Module, module)) {
         reportError(ErrCode::DUPLICATE_IMPORT);
     }
 
-    m_Module->dependencies.insert(&ModuleMap.get(handle));
-    ModuleMap.get(handle).dependents.insert(m_Module);
-
     // specific-symbol import
     if (m_Stream.CurTok.tokenid == Token::PUNC_LBRACE) {
         forwardStream();  // skip '{'
@@ -431,12 +438,9 @@ ImportNode* Parser::parseImport() {
             forwardStream();
             ret.alias = m_StringPool.intern(forwardStream().value);
         }
-        if (m_Stream.CurTok.tokenid == Token::OP_MUL) {  // wildcard
+        if (m_Stream.CurTok.tokenid == Token::OP_MUL) {  // wildcard, expanded by the SymbolResolver
             forwardStream();
             ret.is_wildcard = true;
-            ModuleMap.get(handle).insertExportedSymbolsInto([&imported_symbols](const std::string_view name) {
-                imported_symbols.push_back({.actual_name = name});
-            });
         }
         else forwardStream();
     }
@@ -472,23 +476,15 @@ void Parser::parse() {
         builtin_import->is_wildcard = true;
         builtin_import->is_exported = false;
         builtin_import->mod_handle  = builtin_handle;
-        std::vector<ImportNode::ImportedSymbol_t> imported_symbols;
 
         // TODO: remove duplicate import-registration logic
-        if (!ModuleMap.contains(builtin_handle)) {
-            ModuleMap.insert(builtin_handle, m_Module->getModuleContext());
-
-            ModuleMap.get(builtin_handle).parse(m_ErrorCallback);
-            ModuleMap.get(builtin_handle).performSema(m_ErrorCallback);
+        const auto [builtins, inserted] = ModuleMap.tryInsert(builtin_handle, m_Module->getModuleContext());
+        if (inserted) {
+            builtins->parse(m_ErrorCallback);
+            builtins->performSema(m_ErrorCallback);
         }
 
-        ModuleMap.get(builtin_handle).insertExportedSymbolsInto([&imported_symbols](const std::string_view name) {
-            imported_symbols.push_back({.actual_name = name});
-        });
-
-        builtin_import->imported_symbols = m_Module->internArray<ImportNode::ImportedSymbol_t>(imported_symbols);
-        m_Module->dependencies.insert(&ModuleMap.get(builtin_handle));
-        ModuleMap.get(builtin_handle).dependents.insert(m_Module);
+        ModuleMap.addDependency(m_Module, builtins);
 
         m_Module->ast.emplace_back(builtin_import);
     }
@@ -496,10 +492,6 @@ void Parser::parse() {
     while (!m_Stream.eof()) {
         m_Module->ast.emplace_back(dispatch());
     }
-
-    m_Module->unresolved_deps = m_Module->dependencies.size();
-    if (m_Module->dependencies.empty())
-        ModuleMap.m_ZeroDepVec.push_back(m_Module);
 }
 
 
@@ -507,7 +499,7 @@ Function* Parser::parseFunction() {
     const auto func_nd = m_Module->makeNode<Function>();
     SET_NODE_ATTRS(func_nd);
 
-    const std::string func_ident = m_Stream.next().value;
+    const std::string func_ident{m_Stream.next().value};
     func_nd->name = m_StringPool.intern(func_ident);
 
     // handle the special case of `main`
@@ -744,8 +736,7 @@ GenericArgList Parser::parseGenericArgList() {
         }
 
         // if comptime - parseExpr, otherwise parseType
-        SourceLocation loc;
-        loc.from = m_Stream.getStreamState();
+        const auto from = getTokenStart();
 
         if (m_Stream.CurTok.tokenid == Token::KW_COMPTIME) {
             forwardStream();
@@ -756,8 +747,7 @@ GenericArgList Parser::parseGenericArgList() {
             args.emplace_back(m_Module->makeNode<GenericArg>(expr));
         } else args.emplace_back(m_Module->makeNode<GenericArg>(parseType()));
 
-        loc.to = m_Stream.getStreamState();
-        args.back()->location = loc;
+        args.back()->location = SourceLocation::fromRange(from, getTokenStart());
     }
 
     ret.generic_args = m_Module->internArray<GenericArg*>(args);
@@ -800,7 +790,7 @@ Var* Parser::parseVar(const bool is_comptime) {
 
     ret->is_const = m_Stream.CurTok.value[0] == 'l';
 
-    const std::string var_ident = m_Stream.next().value;
+    const std::string var_ident{m_Stream.next().value};
     forwardStream();  // [:, =]
 
 
@@ -902,7 +892,7 @@ Intrinsic* Parser::parseIntrinsic() {
         call_node->args = m_Module->internArray<Expression*>(arg);
         ignoreButExpect(Token::PUNC_RPAREN);
 
-    } else *call_node = dynamic_cast<FuncCall*>(parseCall(parseIdent()));
+    } else *call_node = cast<FuncCall>(parseCall(parseIdent()));
 
     return call_node;
 }
@@ -1029,7 +1019,7 @@ Enum* Parser::parseEnum() {
 
     forwardStream();  // skip 'enum'
 
-    const std::string enum_name = forwardStream().value;
+    const std::string enum_name{forwardStream().value};
     ret->name = m_StringPool.intern(enum_name);
 
     if (m_Stream.CurTok.tokenid == Token::PUNC_COLON) {
@@ -1037,6 +1027,10 @@ Enum* Parser::parseEnum() {
         ret->enum_type = parseType();
     }
 
+    std::vector<Enum::Entry> entries;
+    std::unordered_set<std::string_view> seen;
+    int counter = 0;
+
     forwardStream(); // skip "{"
     while (m_Stream.CurTok.tokenid != Token::PUNC_RBRACE) {
         if (m_Stream.eof()) {
@@ -1050,7 +1044,11 @@ Enum* Parser::parseEnum() {
         }
          if (m_Stream.CurTok.tokenid == Token::IDENT) {
             const auto name = m_StringPool.intern(forwardStream().value);
-            ret->addEntry(name);
+
+            // a repeated entry keeps its first value, but still uses up one
+            if (seen.insert(name).second) {
+                entries.push_back({name, counter});
+            } counter++;
             continue;
         }
 
@@ -1058,6 +1056,10 @@ Enum* Parser::parseEnum() {
         forwardStream();
     } forwardStream();  // skip '}'
 
+    ret->entries = m_Module->internArray<Enum::Entry>(entries);
+
+    std::ranges::sort(entries, {}, &Enum::Entry::name);
+    ret->sorted_entries = m_Module->internArray<Enum::Entry>(entries);
     return ret;
 }
 
@@ -1092,7 +1094,7 @@ Protocol* Parser::parseProtocol() {
 
         switch (const auto node = dispatch(); node->kind) {
             case ND_FUNC: {
-                const auto fn = node->to<Function>();
+                const auto fn = cast<Function>(node);
                 Protocol::MethodSignature signature;
 
                 std::vector<TypeWrapper*> param_types;
@@ -1110,7 +1112,7 @@ Protocol* Parser::parseProtocol() {
             }
 
             case ND_TYPE_ALIAS: {
-                type_aliases.push_back(node->to<TypeAlias>());
+                type_aliases.push_back(cast<TypeAlias>(node));
                 break;
             }
 
@@ -1212,7 +1214,7 @@ ProtocolImpl* Parser::parseProtocolImpl() {
     if (ret->is_exported) {
         for (Node* child : ret->children->children) {
             if (child->getNodeType() == ND_FUNC)
-                child->to<GlobalNode>()->is_exported = true;
+                cast<GlobalNode>(child)->is_exported = true;
         }
     }
 
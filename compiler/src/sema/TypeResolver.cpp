@@ -345,13 +345,13 @@ sema::TypeResolver::TypeInfo sema::TypeResolver::evaluateType(Op* node, const Ty
                     // static type. the LHS unwraps through any amount of parentheses
                     auto* lhs_node = node->getLHS()->getWrappedNodeOrInstance();
                     if (lhs_node->getNodeType() == ND_OP &&
-                        lhs_node->to<Op>()->op_type == Op::CAST_OP &&
+                        cast<Op>(lhs_node)->op_type == Op::CAST_OP &&
                         analysis_result.deduced_type &&
                         analysis_result.deduced_type->getTypeTag() == Type::PROTOCOL)
                     {
                         auto* protocol_ty = analysis_result.deduced_type->to<ProtocolConstraint>();
                         auto* concrete_type =
-                            inferType(lhs_node->to<Op>()->operands.at(0), ctx).deduced_type;
+                            inferType(cast<Op>(lhs_node)->operands.at(0), ctx).deduced_type;
                         if (!concrete_type)
                             return {};
 
@@ -13,12 +13,16 @@ const std::vector<Argument> application_flags = {
         {{"-r", "--run"}, "Run the executable generated.", false, {}},
         {{"-v", "--version"}, "Show the version of Swirl.", false, {}},
         {{"-j", "--threads"}, "No. of threads to use (excluding the main-thread).", true},
+        {{"-O", "--optimize"}, "Optimization level: 0, 1, 2, 3 or s (e.g. -O2).", true},
         {{"-t", "--target"}, "The target-triple of the target-platform.", true},
         {{"-l", "--library"}, "The name of the library to link against.", true, true},
         {{"-p", "--project"}, "/path/to/project/root.", true},
         {{"-dep", "--dependency"}, "Register a dependency, in the format `path:name`.", true, true},
         {{"-depth", "--depth"}, "Set the recursion-depth.", true, false},
         {{"-d", "--debug"}, "Log the steps of compilation.", false, {}},
+        {{"-pt", "--pretokenize"}, "Lex each file in full before parsing it.", false, {}},
+        {{"-tr", "--time-report"}, "Report the time spent in each phase and write a Chrome trace, lexing counts as parsing unless -pt is given.", false, {}},
+        {{"-mr", "--mem-report"}, "Report the memory used by the allocators and tables, and the peak RSS.", false, {}},
 };
 
 
@@ -66,6 +70,8 @@ int main(const int argc, const char **argv) {
             compiler_inst.setBaseThreadCount(app.get_flag_value("-j"));
         if (app.contains_flag("-t"))
             CompilerInst::setTargetTriple(app.get_flag_value("-t"));
+        if (app.contains_flag("-O"))
+            CompilerInst::setOptimizationLevel(app.get_flag_value("-O"));
         if (app.contains_flag("-depth"))
             CompilerInst::setRecursionDepth(app.get_flag_value("-depth"));
         if (app.contains_flag("-l")) {
@@ -98,6 +104,12 @@ int main(const int argc, const char **argv) {
         if (app.contains_flag("-d")) {
             SW_IS_DEBUG = true;
         }
+        if (app.contains_flag("-pt"))
+            CompilerInst::PreTokenize = true;
+        if (app.contains_flag("-tr"))
+            CompilerInst::TimeReport = true;
+        if (app.contains_flag("-mr"))
+            CompilerInst::MemReport = true;
 
         compiler_inst.compile();
     }
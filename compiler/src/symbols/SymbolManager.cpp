@@ -2,42 +2,21 @@
 #include "modules/ModuleManager.h"
 
 
-TableEntry& SymbolManager::lookupDecl(IdentInfo* id) {
-    static TableEntry fictitious_table_entry{.is_exported = true};
-    if (id->isFictitious()) { return fictitious_table_entry; }
-    if (sw::FileHandle* mod_path = id->getModuleFileHandle(); mod_path != m_ModuleHandle) {
-        return m_ModuleMap.get(mod_path).symbol_table.m_IdToTableEntry.at(id);
-    } return m_IdToTableEntry.at(id);
-}
-
-TableEntry* SymbolManager::searchDecl(IdentInfo* id) {
-    static TableEntry fictitious_table_entry{.is_exported = true};
-    if (id->isFictitious()) { return &fictitious_table_entry; }
-    if (sw::FileHandle* mod_path = id->getModuleFileHandle(); mod_path != m_ModuleHandle) {
-        auto& table = m_ModuleMap.get(mod_path).symbol_table.m_IdToTableEntry;
-        return table.contains(id) ? &table[id] : nullptr;
-    } return m_IdToTableEntry.contains(id) ? &m_IdToTableEntry[id] : nullptr;
-}
-
-
 Type* SymbolManager::lookupType(IdentInfo* id) {
     if (!id) return nullptr;
-    if (const auto mod_path = id->getModuleFileHandle(); mod_path != m_ModuleHandle) {
-        return m_ModuleMap.get(mod_path).symbol_table.m_TypeManager.getFor(id);
+    if (Module* module = id->getModule(); module != m_Module) {
+        return module->symbol_table.m_TypeManager.getFor(id);
     } return m_TypeManager.getFor(id);
 }
 
 
-IdentInfo* SymbolManager::getIdInfoFromModule(sw::FileHandle* mod_path, const std::string& name) const {
+IdentInfo* SymbolManager::getIdInfoFromModule(sw::FileHandle* mod_path, const std::string_view name) const {
     return m_ModuleMap.get(mod_path).symbol_table.getIdInfoOfAGlobal(name, true);
 }
 
 
 Enum* SymbolManager::getFictitiousIDValue(IdentInfo* id) {
-    auto& fictitious_id_table =
-        id->getModuleFileHandle() == m_ModuleHandle
-            ? m_FictitiousIDTable
-            : m_ModuleMap.get(id->getModuleFileHandle()).symbol_table.m_FictitiousIDTable;
+    auto& fictitious_id_table = id->getModule()->symbol_table.m_FictitiousIDTable;
 
     if (fictitious_id_table.contains(id)) {
         return fictitious_id_table[id];
@@ -56,7 +35,7 @@ IdentInfo* SymbolManager::getIDInfoFor(const Ident& id, const std::optional<Erro
     assert(!id.full_qualification.empty());
 
     if (id.full_qualification.size() == 1) {
-        return getIdInfoOfAGlobal(std::string(id.full_qualification.front().name));
+        return getIdInfoOfAGlobal(id.full_qualification.front().name);
     }
 
     // walk the qualifiers (everything but the final segment) to arrive at the
@@ -68,7 +47,7 @@ IdentInfo* SymbolManager::getIDInfoFor(const Ident& id, const std::optional<Erro
         if (counter == id.full_qualification.size() - 1) break;
 
         if (counter == 0) {
-            const auto qual_id = str.value ? str.value : getIdInfoOfAGlobal(std::string(str.name));
+            const auto qual_id = str.value ? str.value : getIdInfoOfAGlobal(str.name);
 
             if (!qual_id)
                 return nullptr;
@@ -131,7 +110,7 @@ IdentInfo* SymbolManager::getIDInfoFor(const Ident& id, const std::optional<Erro
     std::vector<const Namespace*> scopes = {look_at};
     std::vector<Module::ImplScopeRef> impl_refs;
     if (owner_type) {
-        for (const auto& ref : m_ModuleMap.get(m_ModuleHandle).getImplScopesFor(owner_type)) {
+        for (const auto& ref : m_Module->getImplScopesFor(owner_type)) {
             scopes.push_back(ref.info->scope);
             impl_refs.push_back(ref);
         }
@@ -180,7 +159,7 @@ IdentInfo* SymbolManager::getIDInfoFor(const Ident& id, const std::optional<Erro
         // from other modules they require `export impl`
         for (const auto& ref : impl_refs) {
             if (ref.info->scope == matches[0].found_in
-                && ref.info->parent_module != &m_ModuleMap.get(m_ModuleHandle)
+                && ref.info->parent_module != m_Module
                 && !ref.info->is_exported)
             {
                 report_error(
@@ -204,9 +183,14 @@ std::vector<SymbolManager::MemberLookup> SymbolManager::resolveMember(
     const std::string_view name)
 {
     std::vector<MemberLookup> matches;
+
+    // the name is hashed once, rather than once per scope
+    const auto symbol = m_StringPool.findSymbol(name);
+    if (!symbol) return matches;
+
     for (const Namespace* scope : scopes) {
         if (!scope) continue;
-        if (const auto id = scope->getIDInfoFor(name)) {
+        if (const auto id = scope->getIDInfoFor(*symbol)) {
             matches.push_back({.id = *id, .found_in = scope});
         }
     }
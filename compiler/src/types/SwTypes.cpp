@@ -4,11 +4,11 @@
 
 
 std::string FunctionType::toString() const {
-    return ident->toString();
+    return std::string(ident->toString());
 }
 
 std::string StructType::toString() const {
-    return ident->toString();
+    return std::string(ident->toString());
 }
 
 std::string PointerType::toString() const {
@@ -18,7 +18,7 @@ std::string PointerType::toString() const {
 }
 
 std::string EnumType::toString() const {
-    return "enum " + id->toString();
+    return std::format("enum {}", id->toString());
 }
 
 
@@ -0,0 +1,129 @@
+#include <new>
+#include <format>
+#include <cstdlib>
+#include <algorithm>
+#include <stdexcept>
+
+#include "utils/BumpAllocator.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+
+sw::BumpAllocator::BumpAllocator(const std::size_t chunk_size, const Options& options)
+    : m_ChunkSize(chunk_size)
+    , m_MaxChunkSize(std::max(chunk_size, options.max_chunk_size ? options.max_chunk_size : chunk_size * DefaultGrowthLimit))
+    , m_LargeThreshold(chunk_size / 2)
+    , m_UseHugepages(options.hugepages)
+    , m_CurrentChunk(createChunk(chunk_size, nullptr, options.hugepages)) {}
+
+
+std::byte* sw::BumpAllocator::allocateInNewChunk(const std::size_t n, const std::size_t alignment) {
+    // each chunk is twice as large as the previous one, which keeps the no. of chunks logarithmic
+    const auto capacity = std::min(m_CurrentChunk->capacity * 2, m_MaxChunkSize);
+    m_CurrentChunk = createChunk(capacity, m_CurrentChunk, m_UseHugepages);
+
+    std::byte* addr = getAlignedAddress(n, alignment);
+    if (!addr) {
+        throw std::runtime_error(
+            "BumpAllocator::allocate: aligned address calculation failed.");
+    } return addr;
+}
+
+
+std::byte* sw::BumpAllocator::allocateLarge(const std::size_t n, const std::size_t alignment) {
+    // the block is sized for the worst-case padding, its tail is never used by anything else
+    const auto capacity = n + alignment - 1;
+    m_LargeObjects = createChunk(capacity, m_LargeObjects, false);
+
+    std::size_t size_left = m_LargeObjects->capacity;
+    void* pointer = m_LargeObjects->data();
+    const auto addr = static_cast<std::byte*>(std::align(alignment, n, pointer, size_left));
+
+    const auto padding = static_cast<std::size_t>(addr - m_LargeObjects->data());
+    m_LargeObjects->offset = n + padding;
+
+    m_Allocated += n;
+    m_Padding   += padding;
+    return addr;
+}
+
+
+void sw::BumpAllocator::rewind(const Marker& marker) {
+    while (m_CurrentChunk != marker.chunk) {
+        assert(m_CurrentChunk != nullptr && "BumpAllocator::rewind: the marker belongs to another allocator");
+        destroyChunk(std::exchange(m_CurrentChunk, m_CurrentChunk->prev_chunk));
+    }
+
+    while (m_LargeObjects != marker.large) {
+        assert(m_LargeObjects != nullptr && "BumpAllocator::rewind: the marker belongs to another allocator");
+        destroyChunk(std::exchange(m_LargeObjects, m_LargeObjects->prev_chunk));
+    }
+
+    m_CurrentChunk->offset = marker.offset;
+    m_Allocated = marker.allocated;
+    m_Padding   = marker.padding;
+}
+
+
+sw::BumpAllocator::Stats sw::BumpAllocator::getStats() const {
+    Stats ret{.allocated = m_Allocated, .padding = m_Padding};
+    for (const Chunk* it = m_CurrentChunk; it != nullptr; it = it->prev_chunk) {
+        ret.chunks++;
+        ret.reserved += it->capacity;
+        ret.huge_chunks += it->is_mapped;
+        if (it != m_CurrentChunk) {
+            ret.tails += it->capacity - it->offset;
+        }
+    }
+
+    for (const Chunk* it = m_LargeObjects; it != nullptr; it = it->prev_chunk) {
+        ret.large_objects++;
+        ret.large_reserved += it->capacity;
+    } return ret;
+}
+
+
+sw::BumpAllocator::~BumpAllocator() {
+    for (Chunk* list : {m_CurrentChunk, m_LargeObjects}) {
+        while (list != nullptr) {
+            destroyChunk(std::exchange(list, list->prev_chunk));
+        }
+    }
+}
+
+
+sw::BumpAllocator::Chunk* sw::BumpAllocator::createChunk(
+    const std::size_t capacity, Chunk* prev_chunk, const bool allow_hugepages) const
+{
+#ifdef __linux__
+    // only chunks spanning whole hugepages benefit from them, the size is rounded up to a multiple
+    if (allow_hugepages && sizeof(Chunk) + capacity >= HugePageSize) {
+        const auto size = (sizeof(Chunk) + capacity + HugePageSize - 1) / HugePageSize * HugePageSize;
+
+        void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory != MAP_FAILED) {
+            // a hint, the kernel may still back the mapping with regular pages
+            madvise(memory, size, MADV_HUGEPAGE);
+            return std::construct_at(static_cast<Chunk*>(memory), size - sizeof(Chunk), prev_chunk, true);
+        }
+    }
+#endif
+
+    void* memory = malloc(sizeof(Chunk) + capacity);
+    if (!memory) {
+        throw std::bad_alloc();
+    } return std::construct_at(static_cast<Chunk*>(memory), capacity, prev_chunk, false);
+}
+
+
+void sw::BumpAllocator::destroyChunk(Chunk* chunk) {
+#ifdef __linux__
+    if (chunk->is_mapped) {
+        munmap(chunk, sizeof(Chunk) + chunk->capacity);
+        return;
+    }
+#endif
+    free(chunk);
+}
@@ -1,16 +1,44 @@
 #include <cassert>
+#include <cstring>
 #include <ostream>
 #include <fstream>
 #include <filesystem>
 #include <sstream>
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define SW_HAS_MMAP 1
+#endif
 
 #include "utils/FileSystem.h"
+#include "lexer/ScanKernels.h"
+#include "utils/TimeTrace.h"
 
 
 sw::FileHandle::FileHandle(const std::string_view file_path, FileSystem* fs)
     : m_Path(file_path), m_FileSystem(fs) {}
 
 
+sw::FileHandle::FileHandle(const std::string_view file_path, FileSystem* fs, std::string content)
+    : m_Path(file_path), m_FileSystem(fs)
+{
+    std::call_once(m_LoadFlag, [this, &content] { setOwnedContent(std::move(content)); });
+}
+
+
+sw::FileHandle::~FileHandle() {
+#ifdef SW_HAS_MMAP
+    if (m_Mapping) {
+        munmap(m_Mapping, m_MappingSize);
+    }
+#endif
+}
+
+
 const std::filesystem::path& sw::FileHandle::getPath() {
     return m_Path;
 }
@@ -22,32 +50,102 @@ sw::FileSystem* sw::FileHandle::getFileSystemHandle() const {
 
 
 std::string_view sw::FileHandle::readAll() {
-    if (m_FileContent) {
-        return *m_FileContent;
-    }
+    std::call_once(m_LoadFlag, [this] { load(); });
+    return m_Content;
+}
 
-    std::ifstream      f_stream(m_Path);
-    std::ostringstream s_stream;
 
-    s_stream << f_stream.rdbuf();
-    m_FileContent = s_stream.str();
-    return *m_FileContent;
+const std::vector<std::size_t>& sw::FileHandle::getLineOffsets() {
+    const auto content = readAll();
+
+    // only diagnostics need the line-table, hence it isn't built while lexing
+    std::call_once(m_LineOffsetsFlag, [this, content] {
+        m_LineOffsets.push_back(0);
+
+        const char* begin = content.data();
+        const char* end   = begin + content.size();
+        for (auto it = begin; it < end; ) {
+            const auto newline = getScanKernels().findEither(it, end, '\n', '\n');
+            if (newline == end || newline + 1 == end) break;
+
+            it = newline + 1;
+            m_LineOffsets.push_back(it - begin);
+        }
+    });
+
+    return m_LineOffsets;
 }
 
 
-std::unique_ptr<std::istream> sw::FileHandle::getStream() {
-    if (m_FileContent.has_value()) {
-        return std::make_unique<std::istringstream>(*m_FileContent);
+std::string_view sw::FileHandle::getLine(const std::size_t line) {
+    const auto content = readAll();
+    getLineOffsets();
+
+    const auto from = m_LineOffsets.at(line - 1);
+    const auto to   = line < m_LineOffsets.size() ? m_LineOffsets[line] : content.size();
+    return content.substr(from, to - from);
+}
+
+
+sw::FileHandle::LineColumn sw::FileHandle::getLineColumn(const std::size_t offset) {
+    const auto& offsets = getLineOffsets();
+
+    // the last line which starts at or before `offset`
+    const auto line = std::ranges::upper_bound(offsets, offset) - offsets.begin();
+    return {static_cast<std::size_t>(line), offset - offsets[line - 1] + 1};
+}
+
+
+void sw::FileHandle::setOwnedContent(std::string content) {
+    // the lexer expects every line to be terminated
+    if (!content.empty() && content.back() != '\n') {
+        content += '\n';
+    }
+
+    m_OwnedContent = std::move(content);
+    m_Content = m_OwnedContent;
+}
+
+
+void sw::FileHandle::load() {
+    TimeScope scope{"read", m_Path};
+
+#ifdef SW_HAS_MMAP
+    if (const int fd = ::open(m_Path.c_str(), O_RDONLY); fd != -1) {
+        struct stat info{};
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            const auto size = static_cast<std::size_t>(info.st_size);
+            void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            // a mapping cannot be extended, a file which lacks the final newline is read instead
+            if (mapping != MAP_FAILED && static_cast<const char*>(mapping)[size - 1] == '\n') {
+                m_Mapping = mapping;
+                m_MappingSize = size;
+                m_Content = {static_cast<const char*>(mapping), size};
+                close(fd);
+                return;
+            }
+
+            if (mapping != MAP_FAILED) {
+                munmap(mapping, size);
+            }
+        } close(fd);
     }
+#endif
 
-    auto file_stream = std::make_unique<std::ifstream>(m_Path);
-    if (!file_stream->is_open()) {
-        throw std::runtime_error("sw::FileHandle::getStream(): could not open file");
-    } return file_stream;
+    std::ifstream f_stream(m_Path);
+    if (!f_stream.is_open()) {
+        throw std::runtime_error("sw::FileHandle::readAll(): could not open file");
+    }
+
+    std::ostringstream s_stream;
+    s_stream << f_stream.rdbuf();
+    setOwnedContent(std::move(s_stream).str());
 }
 
 
 sw::FileHandle* sw::FileSystem::open(const std::filesystem::path& file_path) {
+    std::lock_guard lock(m_Mutex);
     if (const auto handle = m_FileTable.find(file_path); handle != m_FileTable.end()) {
         return handle->second.get();
     }
@@ -66,11 +164,11 @@ sw::FileHandle* sw::FileSystem::open(const std::string_view file_path) {
 
 
 sw::FileHandle* sw::FileSystem::createVirtualFile(const std::string_view file_path, std::string_view content) {
+    std::lock_guard lock(m_Mutex);
     const auto handle = m_FileTable.find(file_path);
 
     if (handle == m_FileTable.end()) {
-        const auto new_handle = new FileHandle(file_path, this);
-        new_handle->m_FileContent = content;
+        const auto new_handle = new FileHandle(file_path, this, std::string(content));
         m_FileTable[std::string(file_path)] = std::unique_ptr<FileHandle>(new_handle);
 
         assert(new_handle != nullptr);
@@ -82,6 +180,7 @@ sw::FileHandle* sw::FileSystem::createVirtualFile(const std::string_view file_pa
 
 
 sw::FileHandle* sw::FileSystem::fetchHandleFor(const std::string& file_path) {
+    std::lock_guard lock(m_Mutex);
     if (const auto handle = m_FileTable.find(file_path); handle != m_FileTable.end()) {
         return handle->second.get();
     }
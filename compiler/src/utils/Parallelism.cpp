@@ -0,0 +1,130 @@
+#include <limits>
+#include <thread>
+#include <string>
+#include <fstream>
+#include <optional>
+#include <charconv>
+#include <algorithm>
+#include <filesystem>
+
+#include "utils/Parallelism.h"
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+
+namespace {
+/// Roughly what a single emission task needs at the higher optimization levels
+constexpr std::uint64_t MemoryPerEmitTask = 512ull * 1024 * 1024;
+
+/// Parses a decimal, `std::nullopt` if `str` is anything else (the cgroup files are not ours to trust)
+std::optional<std::uint64_t> parseUnsigned(const std::string_view str) {
+    std::uint64_t ret = 0;
+    const auto [end, error] = std::from_chars(str.data(), str.data() + str.size(), ret);
+    if (error != std::errc{} || end != str.data() + str.size()) return std::nullopt;
+    return ret;
+}
+
+
+#ifdef __linux__
+/// Returns the path of the process' cgroup (v2) in the unified hierarchy, if there is one
+std::filesystem::path getCGroupPath() {
+    std::ifstream file("/proc/self/cgroup");
+
+    std::string line;
+    while (std::getline(file, line)) {
+        // the unified hierarchy is listed as `0::/path`
+        if (line.starts_with("0::")) {
+            const auto relative = line.substr(4);
+            return relative.empty() ? "/sys/fs/cgroup" : std::filesystem::path("/sys/fs/cgroup") / relative;
+        }
+    } return {};
+}
+
+
+/// Calls `reader` on the cgroup and each of its ancestors, their limits apply as well
+template <typename Fn>
+void forEachCGroup(Fn reader) {
+    auto path = getCGroupPath();
+    if (path.empty()) return;
+
+    while (true) {
+        reader(path);
+        if (path == "/sys/fs/cgroup" || !path.has_parent_path() || path.parent_path() == path) break;
+        path = path.parent_path();
+    }
+}
+#endif
+}
+
+
+unsigned sw::getAvailableParallelism() {
+    unsigned ret = std::max(1u, std::thread::hardware_concurrency());
+
+#ifdef __linux__
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+        ret = std::min(ret, static_cast<unsigned>(std::max(1, CPU_COUNT(&cpu_set))));
+    }
+
+    forEachCGroup([&ret](const std::filesystem::path& cgroup) {
+        if (const auto cpus = readCPUMax(cgroup / "cpu.max")) ret = std::min(ret, *cpus);
+    });
+#endif
+
+    return ret;
+}
+
+
+std::optional<unsigned> sw::readCPUMax(const std::filesystem::path& path) {
+    // `cpu.max` holds "<quota> <period>" (or "max <period>" when unlimited), a quota of 1.5 periods
+    // still lets 2 threads make progress
+    std::ifstream file(path);
+
+    std::string quota;
+    std::uint64_t period = 0;
+    if (!(file >> quota >> period) || quota == "max" || period == 0) return std::nullopt;
+
+    const auto parsed = parseUnsigned(quota);
+    if (!parsed) return std::nullopt;
+
+    const auto cpus = *parsed / period + (*parsed % period != 0);
+    return static_cast<unsigned>(std::clamp<std::uint64_t>(cpus, 1, std::numeric_limits<unsigned>::max()));
+}
+
+
+std::uint64_t sw::getAvailableMemory() {
+    std::uint64_t ret = 0;
+
+#ifdef __linux__
+    if (const auto pages = sysconf(_SC_PHYS_PAGES), page_size = sysconf(_SC_PAGE_SIZE); pages > 0 && page_size > 0) {
+        ret = static_cast<std::uint64_t>(pages) * page_size;
+    }
+
+    forEachCGroup([&ret](const std::filesystem::path& cgroup) {
+        std::ifstream file(cgroup / "memory.max");
+
+        std::string limit;
+        if (!(file >> limit) || limit == "max") return;
+
+        if (const auto parsed = parseUnsigned(limit)) {
+            ret = ret ? std::min(ret, *parsed) : *parsed;
+        }
+    });
+#endif
+
+    return ret;
+}
+
+
+sw::StageParallelism sw::StageParallelism::fromThreadCount(const unsigned threads) {
+    const auto count = std::max(1u, threads);
+    StageParallelism ret{count, count};
+
+    if (const auto memory = getAvailableMemory()) {
+        ret.emit = static_cast<unsigned>(std::clamp<std::uint64_t>(memory / MemoryPerEmitTask, 1, count));
+    } return ret;
+}
@@ -0,0 +1,71 @@
+#include <limits>
+#include <stdexcept>
+
+#include "utils/StringPool.h"
+
+
+sw::StringPool::StringPool(const std::size_t chunk_size) {
+    for (auto& shard : m_Shards) {
+        shard = std::make_unique<Shard>(chunk_size);
+    }
+}
+
+
+std::string_view sw::StringPool::insert(Shard& shard, const std::string_view str) {
+    std::unique_lock lock(shard.mutex);
+    if (const auto it = shard.strings.find(str); it != shard.strings.end())
+        return *it;
+
+    const SymbolID symbol = m_NextSymbol.fetch_add(1, std::memory_order_relaxed);
+    if (symbol == std::numeric_limits<SymbolID>::max()) {
+        throw std::runtime_error("StringPool::insert: ran out of symbol IDs!");
+    }
+
+    // the ID precedes the chars
+    const auto memory = shard.allocator.allocate(sizeof(SymbolID) + str.size(), alignof(SymbolID));
+    memcpy(memory, &symbol, sizeof(SymbolID));
+    memcpy(memory + sizeof(SymbolID), str.data(), str.size());
+
+    const auto ret = std::string_view{reinterpret_cast<char*>(memory) + sizeof(SymbolID), str.size()};
+    publishSymbol(symbol, ret);
+
+    shard.strings.insert(ret);
+    shard.bytes += str.size();
+    return ret;
+}
+
+
+void sw::StringPool::publishSymbol(const SymbolID symbol, const std::string_view str) {
+    const auto [segment, index] = locateSymbol(symbol);
+
+    std::string_view* entries = m_Symbols[segment].load(std::memory_order_acquire);
+    if (!entries) {
+        std::lock_guard lock(m_SegmentsMutex);
+        entries = m_Symbols[segment].load(std::memory_order_relaxed);
+
+        if (!entries) {
+            entries = new std::string_view[FirstSegmentSize << segment];
+            m_Symbols[segment].store(entries, std::memory_order_release);
+        }
+    }
+
+    entries[index] = str;
+}
+
+
+sw::StringPool::Stats sw::StringPool::getStats() {
+    Stats ret;
+    for (const auto& shard : m_Shards) {
+        std::shared_lock lock(shard->mutex);
+        ret.entries   += shard->strings.size();
+        ret.bytes     += shard->bytes;
+        ret.allocator += shard->allocator.getStats();
+    } return ret;
+}
+
+
+sw::StringPool::~StringPool() {
+    for (auto& segment : m_Symbols) {
+        delete[] segment.load(std::memory_order_relaxed);
+    }
+}
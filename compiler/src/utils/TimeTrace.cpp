@@ -0,0 +1,182 @@
+#include <map>
+#include <print>
+#include <format>
+#include <ranges>
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
+
+#include "utils/TimeTrace.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+#define SW_HAS_THREAD_CPUTIME 1
+#endif
+
+
+namespace {
+std::string escapeJSON(const std::string_view str) {
+    std::string ret;
+    ret.reserve(str.size());
+
+    for (const char chr : str) {
+        switch (chr) {
+            case '"':  ret += "\\\""; break;
+            case '\\': ret += "\\\\"; break;
+            case '\n': ret += "\\n";  break;
+            case '\t': ret += "\\t";  break;
+            default:
+                if (static_cast<unsigned char>(chr) < 0x20) {
+                    ret += std::format("\\u{:04x}", static_cast<unsigned>(chr));
+                } else ret += chr;
+        }
+    } return ret;
+}
+
+double toMillis(const std::chrono::nanoseconds duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+double toMicros(const std::chrono::nanoseconds duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+}
+
+
+void sw::TimeTrace::enable() {
+    StartTime = std::chrono::steady_clock::now();
+    getThreadID();  // the main thread gets the ID 0
+    Enabled.store(true, std::memory_order_relaxed);
+}
+
+
+void sw::TimeTrace::record(Event event) {
+    std::lock_guard lock(EventsMutex);
+    Events.push_back(std::move(event));
+}
+
+
+std::uint32_t sw::TimeTrace::getThreadID() {
+    thread_local const std::uint32_t id = NextThreadID.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+
+std::chrono::nanoseconds sw::TimeTrace::getThreadCPUTime() {
+#ifdef SW_HAS_THREAD_CPUTIME
+    timespec time{};
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) == 0) {
+        return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+    }
+#endif
+    return {};
+}
+
+
+void sw::TimeTrace::writeChromeTrace(const std::filesystem::path& path) {
+    std::lock_guard lock(EventsMutex);
+    std::ofstream file(path);
+
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    for (std::uint32_t thread = 0; thread < NextThreadID.load(std::memory_order_relaxed); thread++) {
+        file << std::format(
+            R"(  {{"name": "thread_name", "ph": "M", "pid": 1, "tid": {}, "args": {{"name": "{}"}}}},)" "\n",
+            thread, thread == 0 ? "main" : std::format("thread-{}", thread));
+    }
+
+    for (std::size_t i = 0; i < Events.size(); i++) {
+        const auto& event = Events[i];
+        file << std::format(
+            R"(  {{"name": "{}", "cat": "swirl", "ph": "X", "pid": 1, "tid": {}, "ts": {:.3f}, "dur": {:.3f}, )"
+            R"("args": {{"detail": "{}", "cpu_ms": {:.3f}}}}}{})" "\n",
+            escapeJSON(event.phase), event.thread, toMicros(event.start), toMicros(event.wall),
+            escapeJSON(event.detail), toMillis(event.cpu), i + 1 == Events.size() ? "" : ",");
+    }
+
+    file << "]}\n";
+}
+
+
+void sw::TimeTrace::printSummary() {
+    std::lock_guard lock(EventsMutex);
+
+    struct Totals {
+        std::chrono::nanoseconds wall{}, cpu{};
+        std::size_t count = 0;
+        std::chrono::nanoseconds first_start = std::chrono::nanoseconds::max();
+
+        void add(const Event& event) {
+            wall += event.wall;
+            cpu  += event.cpu;
+            count++;
+            first_start = std::min(first_start, event.start);
+        }
+    };
+
+    // nested events (e.g. generic instantiation within the TypeResolver) are part of their parents' time,
+    // hence only the outermost ones count towards the modules and threads
+    std::unordered_map<std::string_view, Totals> phases;
+    std::unordered_map<std::string_view, Totals> modules;
+    std::map<std::uint32_t, Totals> threads;
+
+    for (const auto& event : Events) {
+        phases[event.phase].add(event);
+        if (event.depth == 0) {
+            threads[event.thread].add(event);
+            if (!event.detail.empty()) modules[event.detail].add(event);
+        }
+    }
+
+    // the phases are listed in the order they began in
+    std::vector<std::pair<std::string_view, Totals>> ordered_phases(phases.begin(), phases.end());
+    std::ranges::sort(ordered_phases, {}, [](const auto& entry) { return entry.second.first_start; });
+
+    std::vector<std::pair<std::string_view, Totals>> ordered_modules(modules.begin(), modules.end());
+    std::ranges::sort(ordered_modules, std::greater{}, [](const auto& entry) { return entry.second.wall; });
+
+    std::println("===-------------------------------------------------------------------------===");
+    std::println("                          Time report ({:.3f} ms total)", toMillis(sinceStart()));
+    std::println("===-------------------------------------------------------------------------===");
+    std::println("  {:<28} {:>12} {:>12} {:>8}", "Phase", "Wall (ms)", "CPU (ms)", "Count");
+    for (const auto& [phase, totals] : ordered_phases) {
+        std::println("  {:<28} {:>12.3f} {:>12.3f} {:>8}", phase, toMillis(totals.wall), toMillis(totals.cpu), totals.count);
+    }
+
+    constexpr std::size_t MaxModules = 10;
+    std::println("\n  {:<52} {:>12} {:>12}", "Module (slowest first)", "Wall (ms)", "CPU (ms)");
+    for (const auto& [module, totals] : ordered_modules | std::views::take(MaxModules)) {
+        const auto name = module.size() > 52 ? "..." + std::string(module.substr(module.size() - 49)) : std::string(module);
+        std::println("  {:<52} {:>12.3f} {:>12.3f}", name, toMillis(totals.wall), toMillis(totals.cpu));
+    }
+
+    std::println("\n  {:<28} {:>12} {:>12} {:>8}", "Thread", "Busy (ms)", "CPU (ms)", "Events");
+    for (const auto& [thread, totals] : threads) {
+        std::println("  {:<28} {:>12.3f} {:>12.3f} {:>8}", thread == 0 ? "main" : std::format("thread-{}", thread),
+            toMillis(totals.wall), toMillis(totals.cpu), totals.count);
+    }
+}
+
+
+sw::TimeScope::TimeScope(const std::string_view phase, const std::string_view detail) {
+    if (!TimeTrace::isEnabled()) return;
+
+    m_Active = true;
+    m_Event.phase  = phase;
+    m_Event.detail = detail;
+    m_Event.thread = TimeTrace::getThreadID();
+    m_Event.depth  = TimeTrace::tl_Depth++;
+    m_Event.cpu    = TimeTrace::getThreadCPUTime();
+    m_Event.start  = TimeTrace::sinceStart();
+}
+
+sw::TimeScope::TimeScope(const std::string_view phase, const std::filesystem::path& detail)
+    : TimeScope(phase, TimeTrace::isEnabled() ? detail.string() : std::string_view{}) {}
+
+sw::TimeScope::~TimeScope() {
+    if (!m_Active) return;
+
+    m_Event.wall = TimeTrace::sinceStart() - m_Event.start;
+    m_Event.cpu  = TimeTrace::getThreadCPUTime() - m_Event.cpu;
+    TimeTrace::tl_Depth--;
+    TimeTrace::record(std::move(m_Event));
+}
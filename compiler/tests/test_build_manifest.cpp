@@ -0,0 +1,135 @@
+#include <string>
+#include <unordered_map>
+#include <filesystem>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "modules/Module.h"
+#include "modules/ModuleManager.h"
+#include "managers/BuildManifest.h"
+#include "utils/FileSystem.h"
+#include "utils/StringPool.h"
+#include "builtins/builtins.h"
+#include "errors/ErrorManager.h"
+
+
+namespace {
+/// The modules of one build, parsed from in-memory sources. The dependencies between them are recorded
+/// directly instead of through imports, so that cycles can be set up too.
+struct ModuleSet {
+    sw::FileSystem  fs;
+    sw::StringPool  pool{4096};
+    ModuleManager   modman;
+    sw::Target      target{sw::Target::fromHostTriple()};
+    std::unordered_map<std::string, Module*> modules;
+
+    ModuleSet(std::initializer_list<std::pair<std::string_view, std::string_view>> sources) {
+        const auto Triple = target.getTriple();
+        fs.createVirtualFile(SW_BUILTIN_FILE_PATH, SW_BUILTIN_SOURCE);
+
+        for (const auto& [name, source] : sources) {
+            auto* fh = fs.createVirtualFile(name, source);
+            auto* mod = modman.insert(ModuleContext{fh, modman, pool, target});
+            mod->parse([](ErrCode, const ErrorContext&) {});
+            modules[std::string(name)] = mod;
+        }
+    }
+
+    Module* operator[](const std::string& name) const { return modules.at(name); }
+
+    void addDependency(const std::string& dependent, const std::string& dependency) {
+        modman.addDependency(modules.at(dependent), modules.at(dependency));
+    }
+
+    BuildManifest::Entry getEntry(const std::string& name) {
+        ModuleFingerprinter fingerprinter{modman, 0};
+        return fingerprinter.getEntry(modules.at(name));
+    }
+};
+
+
+constexpr std::string_view DepSource = R"(
+export fn value(): i32 { return helper(); }
+fn helper(): i32 { return 1; }
+)";
+
+constexpr std::string_view MainSource = R"(
+fn run() {}
+)";
+}
+
+
+TEST_CASE("Unchanged modules match the manifest of the previous build", "[build][manifest]") {
+    const auto manifest_path = std::filesystem::temp_directory_path() / "swirl-test-manifest";
+
+    ModuleSet first{{"dep.sw", DepSource}, {"main.sw", MainSource}};
+    first.addDependency("main.sw", "dep.sw");
+
+    BuildManifest saved{manifest_path};
+    for (const std::string name : {"dep.sw", "main.sw"}) {
+        saved.set(first.modman.getModuleUID(first[name]->file_handle->getPath()), first.getEntry(name));
+    } saved.save();
+
+    ModuleSet second{{"dep.sw", DepSource}, {"main.sw", MainSource}};
+    second.addDependency("main.sw", "dep.sw");
+
+    BuildManifest loaded{manifest_path};
+    loaded.load();
+    for (const std::string name : {"dep.sw", "main.sw"}) {
+        CHECK(loaded.matches(second.modman.getModuleUID(second[name]->file_handle->getPath()), second.getEntry(name)));
+    }
+
+    std::filesystem::remove(manifest_path);
+}
+
+
+TEST_CASE("Only interface changes invalidate the dependents", "[build][manifest]") {
+    ModuleSet original{{"dep.sw", DepSource}, {"main.sw", MainSource}};
+    original.addDependency("main.sw", "dep.sw");
+
+    SECTION("a change to a non-exported function") {
+        ModuleSet changed{{"dep.sw", R"(
+export fn value(): i32 { return helper(); }
+fn helper(): i32 { return 2; }
+)"}, {"main.sw", MainSource}};
+        changed.addDependency("main.sw", "dep.sw");
+
+        CHECK(changed.getEntry("dep.sw").source_hash != original.getEntry("dep.sw").source_hash);
+        CHECK(changed.getEntry("main.sw") == original.getEntry("main.sw"));
+    }
+
+    SECTION("a change to an exported function") {
+        ModuleSet changed{{"dep.sw", R"(
+export fn value(): i64 { return 1; }
+fn helper(): i32 { return 1; }
+)"}, {"main.sw", MainSource}};
+        changed.addDependency("main.sw", "dep.sw");
+
+        CHECK(changed.getEntry("main.sw").source_hash == original.getEntry("main.sw").source_hash);
+        CHECK(changed.getEntry("main.sw").deps_hash != original.getEntry("main.sw").deps_hash);
+    }
+}
+
+
+TEST_CASE("Interface hashes of an import cycle do not depend on the visiting order", "[build][manifest]") {
+    ModuleSet set{
+        {"a.sw", "export fn a(): i32 { return 1; }"},
+        {"b.sw", "export fn b(): i32 { return 2; }"},
+        {"main.sw", MainSource}
+    };
+
+    set.addDependency("a.sw", "b.sw");
+    set.addDependency("b.sw", "a.sw");
+    set.addDependency("main.sw", "a.sw");
+    set.addDependency("main.sw", "b.sw");
+
+    ModuleFingerprinter a_first{set.modman, 0};
+    const auto a_hash = a_first.getInterfaceHash(set["a.sw"]);
+
+    ModuleFingerprinter b_first{set.modman, 0};
+    const auto b_hash = b_first.getInterfaceHash(set["b.sw"]);
+
+    CHECK(a_hash == b_first.getInterfaceHash(set["a.sw"]));
+    CHECK(b_hash == a_first.getInterfaceHash(set["b.sw"]));
+    CHECK(a_first.getEntry(set["main.sw"]) == b_first.getEntry(set["main.sw"]));
+}
@@ -0,0 +1,121 @@
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "utils/BumpAllocator.h"
+
+
+namespace {
+bool isAligned(const std::byte* ptr, const std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+}
+
+
+TEST_CASE("Oversized allocations get a block of their own", "[allocator][large]") {
+    sw::BumpAllocator allocator{1024};
+    std::byte* small = allocator.allocate(16);
+
+    // far larger than a chunk, used to throw
+    std::byte* large = allocator.allocate(64 * 1024, 64);
+    REQUIRE(large != nullptr);
+    CHECK(isAligned(large, 64));
+    std::memset(large, 0xAB, 64 * 1024);
+
+    // the current chunk is not retired by it
+    std::byte* next = allocator.allocate(16);
+    CHECK(next == small + 16);
+
+    const auto stats = allocator.getStats();
+    CHECK(stats.chunks == 1);
+    CHECK(stats.tails == 0);
+    CHECK(stats.large_objects == 1);
+    CHECK(stats.large_reserved >= 64 * 1024);
+    CHECK(stats.allocated == 16 + 64 * 1024 + 16);
+}
+
+
+TEST_CASE("Chunks grow geometrically up to the limit", "[allocator][growth]") {
+    sw::BumpAllocator allocator{1024, {.max_chunk_size = 8 * 1024}};
+
+    // each allocation stays below the large threshold, 256 of them need several chunks
+    for (int i = 0; i < 256; i++) {
+        const auto* ptr = allocator.allocate(400, 8);
+        REQUIRE(isAligned(ptr, 8));
+    }
+
+    const auto stats = allocator.getStats();
+    CHECK(stats.large_objects == 0);
+    CHECK(stats.allocated == 256 * 400);
+
+    // 1, 2, 4 KiB and then 8 KiB chunks only: 7 KiB in the first three, 8 KiB each after
+    const std::size_t capped = (256 * 400 - 7 * 1024 + 8 * 1024 - 1) / (8 * 1024);
+    CHECK(stats.chunks >= 3 + capped);
+    CHECK(stats.chunks <= 3 + capped + 2);  // the tails of the retired chunks take a few more
+    CHECK(stats.reserved == 7 * 1024 + (stats.chunks - 3) * 8 * 1024);
+}
+
+
+TEST_CASE("Rewinding releases everything allocated after the checkpoint", "[allocator][rewind]") {
+    sw::BumpAllocator allocator{1024, {.max_chunk_size = 4 * 1024}};
+    std::byte* first = allocator.allocate(100);
+    allocator.allocate(2048);  // a large block
+
+    const auto before = allocator.getStats();
+    const auto marker = allocator.checkpoint();
+
+    // spills into new chunks, and adds more large blocks
+    for (int i = 0; i < 64; i++) {
+        allocator.allocate(300);
+    }
+    allocator.allocate(4096);
+    allocator.allocate(10000);
+
+    const auto grown = allocator.getStats();
+    CHECK(grown.chunks > before.chunks);
+    CHECK(grown.large_objects == before.large_objects + 2);
+
+    allocator.rewind(marker);
+    const auto after = allocator.getStats();
+    CHECK(after.chunks         == before.chunks);
+    CHECK(after.reserved       == before.reserved);
+    CHECK(after.allocated      == before.allocated);
+    CHECK(after.padding        == before.padding);
+    CHECK(after.tails          == before.tails);
+    CHECK(after.large_objects  == before.large_objects);
+    CHECK(after.large_reserved == before.large_reserved);
+
+    // the memory after the checkpoint is handed out again
+    const auto again = allocator.checkpoint();
+    CHECK(allocator.allocate(16) == first + 112);  // 100 rounded up to max_align_t
+
+    SECTION("rewinding to the same marker twice") {
+        allocator.rewind(again);
+        allocator.rewind(again);
+        CHECK(allocator.getStats().allocated == before.allocated);
+    }
+}
+
+
+TEST_CASE("Hugepage-backed chunks behave as the others", "[allocator][hugepages]") {
+    constexpr std::size_t ChunkSize = sw::BumpAllocator::HugePageSize;
+    sw::BumpAllocator allocator{ChunkSize, {.hugepages = true}};
+
+    std::vector<std::byte*> ptrs;
+    for (int i = 0; i < 16; i++) {
+        ptrs.push_back(allocator.allocate(1024));
+        std::memset(ptrs.back(), i, 1024);
+    }
+
+    for (int i = 0; i < 16; i++) {
+        CHECK(ptrs[i][0] == static_cast<std::byte>(i));
+        CHECK(ptrs[i][1023] == static_cast<std::byte>(i));
+    }
+
+    const auto stats = allocator.getStats();
+    CHECK(stats.chunks == 1);
+    CHECK(stats.reserved >= ChunkSize);
+    CHECK(stats.huge_chunks <= 1);  // none where mmap is not used or fails
+}
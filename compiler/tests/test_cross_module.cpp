@@ -42,15 +42,14 @@ TEST_CASE("Cross-module impl export gating", "[sema][cross-module]") {
         errors.emplace_back(code, std::move(e));
     });
 
-    // run sema dependency-first (mirrors CompilerInst::compile's batch loop)
-    while (!modman.zeroVecIsEmpty()) {
-        while (const auto m = modman.popZeroDepVec()) {
-            m->performSema([&errors](ErrCode code, ErrorContext e) {
-                errors.emplace_back(code, std::move(e));
-            });
-        }
-        modman.swapBuffers();
-    }
+    // run sema dependency-first (mirrors CompilerInst::compile), the pool has no threads so every
+    // task runs inline
+    sw::ThreadPool thread_pool;
+    modman.scheduleDependenciesFirst(thread_pool, [&errors](Module* m) {
+        m->performSema([&errors](ErrCode code, ErrorContext e) {
+            errors.emplace_back(code, std::move(e));
+        });
+    });
 
     CompilerInst::PackageTable.erase("testpkg");
 
@@ -62,3 +61,44 @@ TEST_CASE("Cross-module impl export gating", "[sema][cross-module]") {
         CHECK(code == ErrCode::PROTO_IMPL_NOT_EXPORTED);
     }
 }
+
+
+TEST_CASE("Structural types are shared by the modules of a compilation", "[sema][cross-module][types]") {
+    sw::FileSystem  fs;
+    sw::StringPool  pool{4096};
+    sw::Target      target{sw::Target::fromHostTriple()};
+    const auto Triple = target.getTriple();
+    fs.createVirtualFile(SW_BUILTIN_FILE_PATH, SW_BUILTIN_SOURCE);
+
+    std::size_t errors = 0;
+    const auto load = [&](ModuleManager& modman, const std::string_view path, const std::string_view source) {
+        auto* mod = modman.insert(ModuleContext{fs.createVirtualFile(path, source), modman, pool, target});
+        mod->parse([&errors](ErrCode, ErrorContext) { errors++; });
+        mod->performSema([&errors](ErrCode, ErrorContext) { errors++; });
+        return mod;
+    };
+
+    ModuleManager modman;
+    Module* a = load(modman, "a.sw", "struct S { var v: i32; }");
+    Module* b = load(modman, "b.sw", "fn run() {}");
+    REQUIRE(errors == 0);
+
+    Type* s = a->symbol_table.lookupType("S");
+    REQUIRE(s != nullptr);
+
+    auto& sym_a = a->symbol_table;
+    auto& sym_b = b->symbol_table;
+    CHECK(sym_a.getPointerType(s, true) == sym_b.getPointerType(s, true));
+    CHECK(sym_a.getArrayType(s, 4) == sym_b.getArrayType(s, 4));
+    CHECK(sym_a.getArrayType(s, 4) != sym_b.getArrayType(s, 5));
+    CHECK(sym_a.getReferenceType(&GlobalTypeI32, true) == sym_b.getReferenceType(&GlobalTypeI32, true));
+    CHECK(sym_a.getSliceType(s, true) == sym_b.getSliceType(s, true));
+
+    // nested ones too
+    CHECK(sym_a.getPointerType(sym_a.getArrayType(s, 2), true) == sym_b.getPointerType(sym_b.getArrayType(s, 2), true));
+
+    // another compilation has types of its own
+    ModuleManager other;
+    Module* c = load(other, "c.sw", "fn run() {}");
+    CHECK(c->symbol_table.getPointerType(&GlobalTypeI32, true) != sym_a.getPointerType(&GlobalTypeI32, true));
+}
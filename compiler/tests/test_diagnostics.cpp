@@ -0,0 +1,105 @@
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "ast/SourceLocation.h"
+#include "errors/ErrorPipeline.h"
+#include "modules/Module.h"
+#include "modules/ModuleManager.h"
+#include "utils/FileSystem.h"
+#include "utils/StringPool.h"
+#include "Target.h"
+
+
+namespace {
+/// Keeps the rendered errors around instead of printing them
+struct CapturingPipeline : ErrorPipeline {
+    [[nodiscard]] std::string_view getOutput() const { return m_ErrorBuffer; }
+};
+
+constexpr std::string_view Source =
+    "fn main() {\n"
+    "    var x: i32 = y + 1;\n"
+    "    var z = call(\n"
+    "        x);\n"
+    "}\n";
+
+/// Renders an error at `[from, to)` of `Source`
+std::string render(const std::size_t from, const std::size_t to) {
+    sw::FileSystem fs;
+    sw::StringPool pool{4096};
+    ModuleManager  modman;
+    sw::Target     target{sw::Target::fromHostTriple()};
+
+    auto* fh = fs.createVirtualFile("test.sw", std::string(Source));
+    auto* mod = modman.insert(ModuleContext{fh, modman, pool, target});
+
+    CapturingPipeline pipeline;
+    pipeline.write("something went wrong", ErrorContext{
+        .location = SourceLocation::fromRange(from, to), .module = mod
+    });
+    return std::string(pipeline.getOutput());
+}
+}
+
+
+TEST_CASE("The whole node is underlined", "[diagnostics]") {
+    const auto from = Source.find("y + 1");
+    CHECK(render(from, from + 5) ==
+        "At test.sw:2:18\n"
+        "\n"
+        "2 |\t    var x: i32 = y + 1;\n"
+        "  |\t                 ^~~~~\n"
+        "\n"
+        "\tError: something went wrong\n\n");
+}
+
+
+TEST_CASE("A single char gets just the caret", "[diagnostics]") {
+    const auto from = Source.find('y');
+    CHECK(render(from, from + 1) ==
+        "At test.sw:2:18\n"
+        "\n"
+        "2 |\t    var x: i32 = y + 1;\n"
+        "  |\t                 ^\n"
+        "\n"
+        "\tError: something went wrong\n\n");
+}
+
+
+TEST_CASE("A node spanning lines is not underlined", "[diagnostics]") {
+    const auto from = Source.find("call(");
+    CHECK(render(from, Source.find(");") + 1) ==
+        "At test.sw:3:13\n"
+        "\n"
+        "3 |\t    var z = call(\n"
+        "  |\t            ^\n"
+        "\n"
+        "\tError: something went wrong\n\n");
+}
+
+
+TEST_CASE("Locations past 4 GiB are clamped", "[diagnostics]") {
+    constexpr std::size_t Max = std::numeric_limits<std::uint32_t>::max();
+
+    const auto inverted = SourceLocation::fromRange(10, 4);
+    CHECK(inverted.offset == 10);
+    CHECK(inverted.length == 0);
+
+    const auto overflowing = SourceLocation::fromRange(Max - 2, Max + 10);
+    CHECK(overflowing.offset == Max - 2);
+    CHECK(overflowing.length == 2);
+    CHECK(overflowing.end() == Max);
+
+    const auto beyond = SourceLocation::fromRange(Max + 5, Max + 10);
+    CHECK(beyond.offset == Max);
+    CHECK(beyond.length == 0);
+
+    auto loc = SourceLocation::fromRange(Max - 10, Max - 5);
+    loc.setEnd(Max + 100);
+    CHECK(loc.end() == Max);
+    loc.setEnd(0);
+    CHECK(loc.length == 0);
+}
@@ -328,3 +328,53 @@ fn run() { var t: T; var r = t.missing(); }
 )");
     CHECK(hasError(f.errors, ErrCode::NO_SUCH_MEMBER));
 }
+
+TEST_CASE("Inner declarations shadow the outer ones until their scope closes", "[sema][scoping]") {
+    SemaFixture f(R"(
+struct A { var a: i32; }
+struct B { var b: i32; }
+fn run() {
+    var x: A;
+    {
+        var x: B;
+        var inner: B = x;
+        {
+            var deepest: B = x;
+        }
+    }
+    var outer: A = x;
+}
+)");
+    CHECK_FALSE(f.hasErrors());
+}
+
+TEST_CASE("Shadowed names resolve to the innermost declaration only", "[sema][scoping]") {
+    SemaFixture f(R"(
+struct A { var a: i32; }
+struct B { var b: i32; }
+fn run() {
+    var x: A;
+    {
+        var x: B;
+        var wrong: A = x;
+    }
+}
+)");
+    CHECK(hasError(f.errors, ErrCode::INCOMPATIBLE_TYPES));
+}
+
+TEST_CASE("Generic params are visible within the scopes they're bound to", "[sema][scoping][generic]") {
+    SemaFixture f(R"(
+struct Box<T> {
+    var value: T;
+    fn get(&self): T { var tmp: T = self.value; return tmp; }
+}
+fn first<U>(x: U): U { var y: U = x; { var z: U = y; } return y; }
+fn run() {
+    var b: Box!{i32};
+    var v: i32 = b.get();
+    var w: i32 = first!{i32}(1);
+}
+)");
+    CHECK_FALSE(f.hasErrors());
+}
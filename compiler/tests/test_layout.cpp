@@ -0,0 +1,167 @@
+#include <format>
+#include <vector>
+#include <algorithm>
+
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/DataLayout.h>
+#include <llvm/IR/DerivedTypes.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "Target.h"
+#include "types/SwTypes.h"
+#include "types/definitions.h"
+#include "modules/Module.h"
+#include "modules/ModuleManager.h"
+#include "utils/FileSystem.h"
+#include "utils/StringPool.h"
+#include "builtins/builtins.h"
+#include "errors/ErrorManager.h"
+
+
+namespace {
+/// The layout LLVM uses for x86-64 Linux
+constexpr auto X64DataLayout = "e-m:e-p270:32:32-p271:32:32-p272:64:64-i64:64-i128:128-f80:128-n8:16:32:64-S128";
+
+struct LayoutFixture {
+    llvm::LLVMContext context;
+    llvm::DataLayout  data_layout{X64DataLayout};
+    sw::Target        target{sw::Target::fromTriple("x86_64-unknown-linux-gnu")};
+
+    llvm::Type* i1   = llvm::Type::getInt1Ty(context);
+    llvm::Type* i8   = llvm::Type::getInt8Ty(context);
+    llvm::Type* i16  = llvm::Type::getInt16Ty(context);
+    llvm::Type* i32  = llvm::Type::getInt32Ty(context);
+    llvm::Type* i64  = llvm::Type::getInt64Ty(context);
+    llvm::Type* i128 = llvm::Type::getInt128Ty(context);
+    llvm::Type* f64  = llvm::Type::getDoubleTy(context);
+
+    /// Checks the size, alignment and field offsets of `type` against the ones of its LLVM counterpart
+    void compare(Type* type, llvm::Type* llvm_type) const {
+        CHECK(target.getSizeInBits(type) == data_layout.getTypeAllocSizeInBits(llvm_type).getFixedValue());
+        CHECK(target.getAllocSize(type) == data_layout.getTypeAllocSize(llvm_type).getFixedValue());
+        CHECK(target.getAlignment(type) == data_layout.getABITypeAlign(llvm_type).value());
+
+        if (type->kind == Type::STRUCT) {
+            const auto* struct_layout = data_layout.getStructLayout(llvm::cast<llvm::StructType>(llvm_type));
+            auto* struct_type = type->to<StructType>();
+
+            for (std::size_t i = 0; i < struct_type->field_types.size(); i++) {
+                INFO("field no. " << i);
+                CHECK(target.getFieldOffset(struct_type, i)
+                    == struct_layout->getElementOffset(static_cast<unsigned>(i)).getFixedValue());
+            }
+        }
+    }
+};
+}
+
+
+TEST_CASE("Aggregate layouts match LLVM's", "[target][layout]") {
+    LayoutFixture f;
+
+    StructType padded;
+    padded.field_types = {&GlobalTypeBool, &GlobalTypeI64, &GlobalTypeI8};
+    padded.is_complete = true;
+    const auto llvm_padded = llvm::StructType::get(f.context, {f.i1, f.i64, f.i8});
+
+    ArrayType bools{&GlobalTypeBool, 5};
+    const auto llvm_bools = llvm::ArrayType::get(f.i1, 5);
+
+    ArrayType structs{&padded, 3};
+    const auto llvm_structs = llvm::ArrayType::get(llvm_padded, 3);
+
+    SECTION("a struct with padding") {
+        f.compare(&padded, llvm_padded);
+    }
+
+    SECTION("an array of bools, a byte each") {
+        f.compare(&bools, llvm_bools);
+        CHECK(f.target.getAllocSize(&bools) == 5);
+    }
+
+    SECTION("an array of structs") {
+        f.compare(&structs, llvm_structs);
+    }
+
+    SECTION("nested structs") {
+        StructType nested;
+        nested.field_types = {&GlobalTypeI16, &structs, &GlobalTypeI32, &GlobalTypeF64, &bools};
+        f.compare(&nested, llvm::StructType::get(f.context, {f.i16, llvm_structs, f.i32, f.f64, llvm_bools}));
+
+        StructType outer;
+        outer.field_types = {&GlobalTypeI8, &nested, &padded};
+        f.compare(&outer, llvm::StructType::get(f.context,
+            {f.i8, llvm::StructType::get(f.context, {f.i16, llvm_structs, f.i32, f.f64, llvm_bools}), llvm_padded}));
+    }
+
+    SECTION("an i128 field") {
+        StructType wide;
+        wide.field_types = {&GlobalTypeI8, &GlobalTypeI128};
+        f.compare(&wide, llvm::StructType::get(f.context, {f.i8, f.i128}));
+        CHECK(f.target.getFieldOffset(&wide, 1) == 16);
+    }
+
+    SECTION("an empty struct, lowered to { i8 }") {
+        StructType empty;
+        f.compare(&empty, llvm::StructType::get(f.context, llvm::ArrayRef<llvm::Type*>{f.i8}));
+        CHECK(f.target.getAllocSize(&empty) == 1);
+    }
+}
+
+
+TEST_CASE("Layouts are cached once the structs are complete", "[target][layout]") {
+    auto target = sw::Target::fromTriple("x86_64-unknown-linux-gnu");
+
+    StructType type;
+    type.field_types = {&GlobalTypeI8};
+    ArrayType array{&type, 2};
+    CHECK(target.getAllocSize(&type) == 1);
+    CHECK(target.getAllocSize(&array) == 2);
+
+    // its fields being resolved
+    type.field_types = {&GlobalTypeI8, &GlobalTypeI64};
+    type.is_complete = true;
+    CHECK(target.getAllocSize(&type) == 16);
+    CHECK(target.getAllocSize(&array) == 32);
+    CHECK(target.getFieldOffset(&type, 1) == 8);
+
+    // stands in for a struct of a later compilation, allocated where this one used to be
+    target.clearLayouts();
+    type.field_types = {&GlobalTypeI32};
+    CHECK(target.getAllocSize(&type) == 4);
+    CHECK(target.getAllocSize(&array) == 8);
+}
+
+
+TEST_CASE("sizeof a struct from within itself doesn't stick", "[target][layout][sema]") {
+    sw::FileSystem fs;
+    sw::StringPool pool{4096};
+    ModuleManager  modman;
+    sw::Target     target{sw::Target::fromHostTriple()};
+    const auto Triple = target.getTriple();
+    fs.createVirtualFile(SW_BUILTIN_FILE_PATH, SW_BUILTIN_SOURCE);
+
+    const auto check = [&](const std::string_view expected_size) {
+        const auto source = std::format(R"(
+struct S {{
+    var a: i64;
+    var b: i8;
+    fn bytes(&self): i64 {{ var inside: [u8 | sizeof(S)]; return 0; }}
+}}
+fn run() {{ var after: [u8 | sizeof(S)]; var check: [u8 | {}] = after; }}
+)", expected_size);
+
+        std::vector<ErrCode> errors;
+        auto* fh = fs.createVirtualFile(std::format("test{}.sw", expected_size), source);
+        auto* mod = modman.insert(ModuleContext{fh, modman, pool, target});
+        mod->parse([&errors](ErrCode code, ErrorContext) { errors.push_back(code); });
+        mod->performSema([&errors](ErrCode code, ErrorContext) { errors.push_back(code); });
+
+        CHECK(target.getAllocSize(mod->symbol_table.lookupType("S")) == 16);
+        return std::ranges::find(errors, ErrCode::DISTINCTLY_SIZED_ARR) == errors.end();
+    };
+
+    CHECK(check("16"));
+    CHECK_FALSE(check("8"));
+}
@@ -1,4 +1,10 @@
+#include <chrono>
+#include <format>
+#include <algorithm>
+#include <unordered_map>
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include "lexer/PerfectHash.h"
 #include "lexer/TokenStream.h"
 #include "managers/SourceManager.h"
 #include "modules/Module.h"
@@ -21,7 +27,7 @@ struct LexerFixture {
         ModuleContext ctx{fh, modman, pool, target};
         mod = modman.insert(ctx);
         sm  = new SourceManager(mod);
-        lex = new TokenStream(*sm);
+        lex = new TokenStream(*sm, pool);
     }
 
     ~LexerFixture() {
@@ -339,6 +345,30 @@ TEST_CASE("dot after identifier is member access, not float", "[lexer][numbers]"
     CHECK(f.next().type == NONE);
 }
 
+TEST_CASE("dot after whitespace following an identifier starts a float", "[lexer][numbers]") {
+    SECTION("space") {
+        LexerFixture f("x .5");
+        CHECK_TOK(f.next(), IDENT,  "x", Token::IDENT);
+        CHECK_TOK(f.next(), NUMBER, "0.5", Token::NUM_FLOAT);
+        CHECK(f.next().type == NONE);
+    }
+    SECTION("newline") {
+        LexerFixture f("x\n.5");
+        CHECK_TOK(f.next(), IDENT,  "x", Token::IDENT);
+        CHECK_TOK(f.next(), NUMBER, "0.5", Token::NUM_FLOAT);
+        CHECK(f.next().type == NONE);
+    }
+}
+
+TEST_CASE("stray control chars separate tokens", "[lexer][edge]") {
+    LexerFixture f("a\x01" "b\x7f.5 \x1f" "c");
+    CHECK_TOK(f.next(), IDENT,  "a", Token::IDENT);
+    CHECK_TOK(f.next(), IDENT,  "b", Token::IDENT);
+    CHECK_TOK(f.next(), NUMBER, "0.5", Token::NUM_FLOAT);
+    CHECK_TOK(f.next(), IDENT,  "c", Token::IDENT);
+    CHECK(f.next().type == NONE);
+}
+
 TEST_CASE("number adjacent to identifier is separate tokens", "[lexer]") {
     LexerFixture f("42foo");
     CHECK_TOK(f.next(), NUMBER, "42", Token::NUM_INT);
@@ -669,3 +699,233 @@ TEST_CASE("tokenize module import", "[lexer][integration]") {
     CHECK_TOK(f.next(), PUNC,    ";",      Token::PUNC_SEMI);
     CHECK(f.next().type == NONE);
 }
+
+// ──────────────────────────────────────────────────────────
+// Scanning kernels
+// ──────────────────────────────────────────────────────────
+/// A few thousand lines exercising every kind of token, with runs shorter and longer than a vector so
+/// that the scanning kernels' tails get exercised as well
+static std::string generateSource() {
+    const std::string snippet =
+        "fn an_identifier_longer_than_thirty_two_bytes_x(a: i32, b_: f64) -> i32 {\n"
+        "    // a comment which spans more than a single 32-byte block of the source\n"
+        "    var s = \"a string with \\\"escapes\\\" and a \\\\ backslash which is fairly long\";\n"
+        "    let c = 'x'; let n = 1_000_000_000_000_000_000_000_000_000_000_000 + 0x_ff + 3.14_15;\n"
+        "\t\t\r\n                                          \x7f\n"
+        "    return a+b_*.5; //\n"
+        "}\n";
+
+    std::string source;
+    for (int i = 0; i < 2000; i++)
+        source += snippet;
+    return source;
+}
+
+static bool isSameToken(const Token& lhs, const Token& rhs) {
+    return lhs.type == rhs.type && lhs.value == rhs.value && lhs.tokenid == rhs.tokenid
+        && lhs.location.Line == rhs.location.Line && lhs.location.Col == rhs.location.Col
+        && lhs.location.Pos == rhs.location.Pos;
+}
+
+TEST_CASE("scanning kernels tokenize identically to the scalar ones", "[lexer][kernels]") {
+    const auto source = generateSource();
+
+    const auto tokenize = [&source](LexerFixture& f, const sw::ScanKernels& kernels) {
+        f.lex->setScanKernels(kernels);
+
+        std::vector<Token> ret;
+        const auto start = std::chrono::steady_clock::now();
+        for (auto tok = f.next(); tok.type != NONE; tok = f.next())
+            ret.push_back(tok);
+
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        SUCCEED(std::format("{}: {:.1f} MiB/s", kernels.name, source.size() / elapsed.count() / (1 << 20)));
+        return ret;
+    };
+
+    LexerFixture scalar(source);
+    const auto expected = tokenize(scalar, sw::getScalarScanKernels());
+    REQUIRE(expected.size() > 2000);
+
+    for (const auto* kernels : sw::getSupportedScanKernels()) {
+        INFO(kernels->name);
+        LexerFixture f(source);
+        const auto tokens = tokenize(f, *kernels);
+
+        const auto mismatch = std::ranges::mismatch(tokens, expected, isSameToken);
+
+        INFO("first mismatch at token " << mismatch.in1 - tokens.begin());
+        CHECK(tokens.size() == expected.size());
+        CHECK(mismatch.in1 == tokens.end());
+    }
+}
+
+TEST_CASE("scanning kernels find the ends of runs", "[lexer][kernels]") {
+    const std::string ident(100, 'a'), digits = "1_2" + std::string(70, '3'), ws = " \t\n\v\f\r" + std::string(40, ' ');
+
+    for (const auto* kernels : sw::getSupportedScanKernels()) {
+        INFO(kernels->name);
+        for (std::size_t len = 0; len <= ident.size(); len++) {
+            const auto str = ident.substr(0, len) + "+" + std::string(40, 'b');
+            CHECK(kernels->skipIdent(str.data(), str.data() + str.size()) == str.data() + len);
+        }
+
+        const auto num = digits + "." + std::string(40, '4');
+        CHECK(kernels->skipDigits(num.data(), num.data() + num.size()) == num.data() + digits.size());
+
+        for (const char stop : {'\x01', '\x08', '\x0e', '\x1f', '\x7f', '\x80', '!'}) {
+            const auto str = ws + stop + std::string(40, ' ');
+            CHECK(kernels->skipWhitespace(str.data(), str.data() + str.size()) == str.data() + ws.size());
+        }
+
+        const auto str = std::string(50, 'x') + "\\" + std::string(20, 'y') + "\"";
+        CHECK(kernels->findEither(str.data(), str.data() + str.size(), '"', '\\') == str.data() + 50);
+        CHECK(kernels->findEither(str.data() + 51, str.data() + str.size(), '"', '\\') == str.data() + 71);
+        CHECK(kernels->findEither(str.data(), str.data() + 50, '"', '\\') == str.data() + 50);
+    }
+}
+
+// ──────────────────────────────────────────────────────────
+// Keyword & operator tables
+// ──────────────────────────────────────────────────────────
+TEST_CASE("perfect hash tables find exactly their spellings", "[lexer][keywords]") {
+    for (const auto& spelling : KeywordTable.getSpellings()) {
+        INFO(spelling.text);
+        REQUIRE(KeywordTable.find(spelling.text) == &spelling);
+        CHECK_FALSE(OperatorTable.find(spelling.text));
+    }
+
+    for (const auto& spelling : OperatorTable.getSpellings()) {
+        INFO(spelling.text);
+        REQUIRE(OperatorTable.find(spelling.text) == &spelling);
+        CHECK_FALSE(KeywordTable.find(spelling.text));
+    }
+
+    // same length and first/last chars as keywords
+    for (const auto str : {"", "continue_", "contnue", "coxxxxxe", "comptimf", "iff", "ef", "a", "structs", "===", "->", "..."}) {
+        INFO(str);
+        CHECK_FALSE(KeywordTable.find(str));
+        CHECK_FALSE(OperatorTable.find(str));
+    }
+}
+
+TEST_CASE("keyword lookup on identifier-heavy input", "[lexer][keywords][!benchmark]") {
+    // the hash-map the lexer used to look keywords up in, as the baseline
+    std::unordered_map<std::string_view, Token::TokenValue> keyword_map;
+    for (const auto& spelling : KeywordTable.getSpellings())
+        keyword_map.emplace(spelling.text, spelling.id);
+
+    const auto source = generateSource();
+    LexerFixture f(source);
+
+    std::vector<std::string_view> words;
+    for (auto tok = f.next(); tok.type != NONE; tok = f.next()) {
+        if (tok.type == IDENT || tok.type == KEYWORD) words.push_back(tok.value);
+    }
+
+    for (const auto word : words)
+        REQUIRE(keyword_map.contains(word) == (KeywordTable.find(word) != nullptr));
+
+    BENCHMARK("std::unordered_map") {
+        std::size_t count = 0;
+        for (const auto word : words) count += keyword_map.contains(word);
+        return count;
+    };
+
+    BENCHMARK("perfect hash") {
+        std::size_t count = 0;
+        for (const auto word : words) count += KeywordTable.find(word) != nullptr;
+        return count;
+    };
+}
+
+// ──────────────────────────────────────────────────────────
+// Pre-tokenization
+// ──────────────────────────────────────────────────────────
+TEST_CASE("pre-tokenized stream matches the on-demand lexer", "[lexer][buffer]") {
+    const auto source = generateSource();
+    LexerFixture live(source), buffered(source);
+    buffered.lex->pretokenize();
+
+    REQUIRE(buffered.lex->isPretokenized());
+    CHECK(buffered.lex->getTokenBuffer().size() > 2000);
+
+    bool all_same = true;
+    std::size_t count = 0;
+    while (all_same) {
+        all_same = isSameToken(live.lex->peek(), buffered.lex->peek())
+            && isSameToken(live.next(), buffered.next())
+            && live.lex->getStreamState().Pos == buffered.lex->getStreamState().Pos
+            && live.lex->getStreamState().Line == buffered.lex->getStreamState().Line
+            && live.lex->getStreamState().Col == buffered.lex->getStreamState().Col;
+
+        if (live.lex->eof()) break;
+        count++;
+    }
+
+    INFO("first mismatch at token " << count);
+    CHECK(all_same);
+    CHECK(buffered.lex->eof());
+    CHECK(buffered.next().type == NONE);
+}
+
+TEST_CASE("pre-tokenized stream backtracks through its index", "[lexer][buffer]") {
+    LexerFixture f("let x = \"" + std::string(70000, 's') + "\";\nx");
+    f.lex->pretokenize();
+
+    CHECK_TOK(f.next(), KEYWORD, "let", Token::KW_LET);
+    f.lex->setReturnPoint();
+    CHECK_TOK(f.next(), IDENT,   "x",   Token::IDENT);
+    CHECK_TOK(f.next(), OP,      "=",   Token::OP_ASSIGN);
+    f.lex->restoreCache();
+
+    CHECK_TOK(f.next(), IDENT,   "x",   Token::IDENT);
+    CHECK_TOK(f.next(), OP,      "=",   Token::OP_ASSIGN);
+
+    // longer than the 16-bit length of the buffer can hold
+    const auto str = f.next();
+    CHECK(str.type == STRING);
+    CHECK(str.value == std::string(70000, 's'));
+
+    CHECK_TOK(f.next(), PUNC,  ";", Token::PUNC_SEMI);
+    const auto last = f.next();
+    CHECK(last.value == "x");
+    CHECK(last.location.Line == 2);
+    CHECK(last.location.Col == 1);
+    CHECK(f.next().type == NONE);
+}
+
+TEST_CASE("peek returns the pushed-back token in either mode", "[lexer][buffer][peek]") {
+    const auto run = [](LexerFixture& f) {
+        CHECK_TOK(f.next(), IDENT, "a", Token::IDENT);
+        const auto gt = f.next();
+        REQUIRE(gt.value == ">");
+
+        f.lex->pushback(gt);
+        CHECK_TOK(f.lex->peek(), OP, ">", gt.tokenid);
+        CHECK_TOK(f.next(), OP, ">", gt.tokenid);
+        CHECK_TOK(f.lex->peek(), IDENT, "b", Token::IDENT);
+        CHECK_TOK(f.next(), IDENT, "b", Token::IDENT);
+    };
+
+    LexerFixture live("a > b");
+    run(live);
+
+    LexerFixture buffered("a > b");
+    buffered.lex->pretokenize();
+    run(buffered);
+}
+
+TEST_CASE("a stream serves the tokens lexed by another one", "[lexer][buffer]") {
+    LexerFixture lexer("let x = 1;"), parser("let x = 1;");
+    lexer.lex->pretokenize();
+    parser.lex->adoptTokenBuffer(lexer.lex->takeTokenBuffer());
+
+    REQUIRE(parser.lex->isPretokenized());
+    CHECK_TOK(parser.next(), KEYWORD, "let", Token::KW_LET);
+    CHECK_TOK(parser.next(), IDENT,   "x",   Token::IDENT);
+    CHECK_TOK(parser.next(), OP,      "=",   Token::OP_ASSIGN);
+    CHECK(parser.next().type == NUMBER);
+    CHECK_TOK(parser.next(), PUNC,    ";",   Token::PUNC_SEMI);
+    CHECK(parser.next().type == NONE);
+}
@@ -0,0 +1,53 @@
+#include <fstream>
+#include <filesystem>
+#include <string_view>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "utils/Parallelism.h"
+
+
+namespace {
+/// Reads `contents` back through `sw::readCPUMax`
+std::optional<unsigned> readCPUMaxOf(const std::string_view contents) {
+    const auto path = std::filesystem::temp_directory_path() / "swirl-test-cpu.max";
+    std::ofstream(path) << contents;
+
+    const auto ret = sw::readCPUMax(path);
+    std::filesystem::remove(path);
+    return ret;
+}
+}
+
+
+TEST_CASE("cpu.max quotas are rounded up to whole CPUs", "[parallelism][cgroup]") {
+    CHECK(readCPUMaxOf("200000 100000\n") == 2u);
+    CHECK(readCPUMaxOf("150000 100000\n") == 2u);  // 1.5 CPUs still keep 2 threads busy
+    CHECK(readCPUMaxOf("100001 100000\n") == 2u);
+    CHECK(readCPUMaxOf("50000 100000\n") == 1u);
+    CHECK(readCPUMaxOf("1 100000\n") == 1u);
+}
+
+
+TEST_CASE("Unlimited, malformed and missing cpu.max files set no limit", "[parallelism][cgroup]") {
+    CHECK_FALSE(readCPUMaxOf("max 100000\n").has_value());
+    CHECK_FALSE(readCPUMaxOf("").has_value());
+    CHECK_FALSE(readCPUMaxOf("100000\n").has_value());
+    CHECK_FALSE(readCPUMaxOf("100000 0\n").has_value());
+    CHECK_FALSE(readCPUMaxOf("-5 100000\n").has_value());
+    CHECK_FALSE(readCPUMaxOf("1.5 100000\n").has_value());
+
+    const auto missing = std::filesystem::temp_directory_path() / "swirl-test-missing" / "cpu.max";
+    CHECK_FALSE(sw::readCPUMax(missing).has_value());
+}
+
+
+TEST_CASE("Only emission is bounded by memory", "[parallelism]") {
+    const auto stages = sw::StageParallelism::fromThreadCount(8);
+    CHECK(stages.frontend == 8);
+    CHECK(stages.emit >= 1);
+    CHECK(stages.emit <= 8);
+
+    CHECK(sw::StageParallelism::fromThreadCount(0).frontend == 1);
+    CHECK(sw::getAvailableParallelism() >= 1);
+}
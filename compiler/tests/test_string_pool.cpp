@@ -0,0 +1,89 @@
+#include <string>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "utils/StringPool.h"
+
+
+TEST_CASE("Equal strings are interned once", "[stringpool]") {
+    sw::StringPool pool{1024};
+
+    const std::string first = "identifier", second = "identifier";
+    const auto a = pool.intern(first);
+    const auto b = pool.intern(second);
+
+    CHECK(a == "identifier");
+    CHECK(a.data() == b.data());
+    CHECK(a.data() != first.data());
+    CHECK(pool.getSymbol(a) == pool.getSymbol(b));
+    CHECK(pool.internSymbol("identifier") == pool.getSymbol(a));
+
+    CHECK(pool.getSymbol(pool.intern("other")) != pool.getSymbol(a));
+    CHECK(pool.size() == 2);
+}
+
+
+TEST_CASE("IDs map back to their strings across the segments", "[stringpool]") {
+    sw::StringPool pool{1024};
+
+    // the segments hold 1024, 2048 and 4096 IDs, the third one starts at 3072
+    std::vector<std::string_view> interned;
+    for (int i = 0; i < 5000; i++) {
+        interned.push_back(pool.intern("s" + std::to_string(i)));
+    }
+
+    for (const int i : {0, 1, 1023, 1024, 1025, 3071, 3072, 3073, 4999}) {
+        INFO("string no. " << i);
+        const auto id = pool.getSymbol(interned[i]);
+        CHECK(id == static_cast<sw::SymbolID>(i));
+        CHECK(pool.getString(id).data() == interned[i].data());
+        CHECK(pool.getString(id) == "s" + std::to_string(i));
+    }
+}
+
+
+TEST_CASE("findSymbol does not intern", "[stringpool]") {
+    sw::StringPool pool{1024};
+    const auto id = pool.internSymbol("known");
+
+    CHECK(pool.findSymbol("known") == id);
+    CHECK_FALSE(pool.findSymbol("unknown").has_value());
+    CHECK(pool.size() == 1);
+    CHECK(pool.getStats().entries == 1);
+    CHECK_FALSE(pool.findSymbol("unknown").has_value());
+}
+
+
+TEST_CASE("Concurrent interning hands out unique and dense IDs", "[stringpool][threads]") {
+    constexpr int ThreadCount = 8, StringCount = 4000;
+    sw::StringPool pool{1024};
+
+    // every thread interns the same strings, in a different order
+    std::vector<std::vector<sw::SymbolID>> ids(ThreadCount, std::vector<sw::SymbolID>(StringCount));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < ThreadCount; t++) {
+        threads.emplace_back([&pool, &ids, t] {
+            for (int i = 0; i < StringCount; i++) {
+                const int n = (i * 7 + t * 997) % StringCount;
+                ids[t][n] = pool.internSymbol("str" + std::to_string(n));
+            }
+        });
+    }
+
+    for (auto& thread : threads) thread.join();
+
+    REQUIRE(pool.size() == StringCount);
+    for (int t = 1; t < ThreadCount; t++) {
+        CHECK(ids[t] == ids[0]);
+    }
+
+    auto sorted = ids[0];
+    std::ranges::sort(sorted);
+    for (int i = 0; i < StringCount; i++) {
+        REQUIRE(sorted[i] == static_cast<sw::SymbolID>(i));
+        CHECK(pool.getString(ids[0][i]) == "str" + std::to_string(i));
+    }
+}
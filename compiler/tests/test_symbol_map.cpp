@@ -0,0 +1,135 @@
+#include <map>
+#include <vector>
+#include <algorithm>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "utils/SymbolMap.h"
+
+
+namespace {
+/// The home slot of `key` in a map of 8 slots, mirrors `SymbolMap::getHomeSlot`
+std::size_t getHomeSlotOf8(const sw::SymbolID key) {
+    return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> 61) & 7;
+}
+}
+
+
+TEST_CASE("Entries survive the map growing", "[symbolmap]") {
+    sw::SymbolMap<std::uint64_t> map;
+    CHECK(map.find(0) == nullptr);
+
+    // 8 slots at first, doubled each time 3/4 of them are taken
+    constexpr sw::SymbolID Count = 5000;
+    for (sw::SymbolID key = 0; key < Count; key++) {
+        const auto [value, inserted] = map.tryEmplace(key);
+        REQUIRE(inserted);
+        *value = std::uint64_t{key} * 3;
+    }
+
+    REQUIRE(map.size() == Count);
+    for (sw::SymbolID key = 0; key < Count; key++) {
+        const auto* value = map.find(key);
+        REQUIRE(value != nullptr);
+        CHECK(*value == std::uint64_t{key} * 3);
+    }
+
+    CHECK_FALSE(map.contains(Count));
+    CHECK_FALSE(map.contains(Count * 2));
+}
+
+
+TEST_CASE("tryEmplace keeps the existing entry", "[symbolmap]") {
+    sw::SymbolMap<int> map;
+
+    const auto [first, inserted] = map.tryEmplace(42);
+    REQUIRE(inserted);
+    CHECK(*first == 0);  // value-initialized
+    *first = 7;
+
+    const auto [second, inserted_again] = map.tryEmplace(42);
+    CHECK_FALSE(inserted_again);
+    CHECK(second == first);
+    CHECK(*second == 7);
+    CHECK(map.size() == 1);
+
+    map[42]++;
+    CHECK(*map.find(42) == 8);
+    CHECK(map.size() == 1);
+}
+
+
+TEST_CASE("tryEmplace of a present key does not grow a full map", "[symbolmap]") {
+    sw::SymbolMap<int> map;
+
+    // 6 of the first 8 slots, the next insertion grows the map
+    std::vector<int*> values;
+    for (sw::SymbolID key = 0; key < 6; key++) {
+        values.push_back(map.tryEmplace(key).first);
+    }
+
+    for (sw::SymbolID key = 0; key < 6; key++) {
+        const auto [value, inserted] = map.tryEmplace(key);
+        CHECK_FALSE(inserted);
+        CHECK(value == values[key]);  // not moved by a rehash
+    }
+
+    const auto [value, inserted] = map.tryEmplace(6);
+    CHECK(inserted);
+    CHECK(map.size() == 7);
+    CHECK(map.find(6) == value);
+    for (sw::SymbolID key = 0; key < 6; key++) {
+        CHECK(map.contains(key));
+    }
+}
+
+
+TEST_CASE("Absent keys are not found at the end of a long probe chain", "[symbolmap]") {
+    // the keys which all start probing at the same slot of the first 8
+    std::vector<sw::SymbolID> colliding;
+    for (sw::SymbolID key = 0; colliding.size() < 7; key++) {
+        if (getHomeSlotOf8(key) == 3) colliding.push_back(key);
+    }
+
+    // 6 entries fill the first 8 slots up to the load limit, in a single chain
+    sw::SymbolMap<int> map;
+    for (int i = 0; i < 6; i++) {
+        *map.tryEmplace(colliding[i]).first = i;
+    }
+
+    const auto absent = colliding[6];
+    CHECK(map.find(absent) == nullptr);
+    CHECK_FALSE(map.contains(absent));
+
+    for (int i = 0; i < 6; i++) {
+        REQUIRE(map.find(colliding[i]) != nullptr);
+        CHECK(*map.find(colliding[i]) == i);
+    }
+
+    // none of the other keys are found either, whichever chain they probe
+    for (sw::SymbolID key = 0; key < 1000; key++) {
+        if (std::ranges::find(colliding.begin(), colliding.begin() + 6, key) == colliding.begin() + 6)
+            CHECK(map.find(key) == nullptr);
+    }
+}
+
+
+TEST_CASE("forEach visits every entry once", "[symbolmap]") {
+    sw::SymbolMap<sw::SymbolID> map;
+    std::map<sw::SymbolID, sw::SymbolID> expected;
+
+    // scattered keys, across a few grows
+    for (sw::SymbolID i = 0; i < 300; i++) {
+        const sw::SymbolID key = i * 7919 % 100003;
+        map[key] = i;
+        expected[key] = i;
+    }
+
+    std::map<sw::SymbolID, sw::SymbolID> visited;
+    map.forEach([&](const sw::SymbolID key, const sw::SymbolID value) {
+        CHECK(visited.emplace(key, value).second);
+    });
+
+    CHECK(visited == expected);
+    CHECK(map.size() == expected.size());
+}
@@ -0,0 +1,148 @@
+#include <set>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <stdexcept>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "utils/Threadpool.h"
+
+
+TEST_CASE("Tasks enqueued from within tasks are waited upon", "[threadpool]") {
+    sw::ThreadPool pool;
+    pool.setBaseThreadCount(4);
+
+    std::atomic<int> count = 0;
+    for (int i = 0; i < 16; i++) {
+        pool.enqueue([&] {
+            count++;
+            for (int j = 0; j < 16; j++) {
+                pool.enqueue([&] {
+                    count++;
+                    pool.enqueue([&] { count++; });
+                });
+            }
+        });
+    }
+
+    pool.wait();
+    CHECK(count == 16 + 16 * 16 * 2);
+}
+
+
+TEST_CASE("Task groups are waited upon independently", "[threadpool][group]") {
+    sw::ThreadPool pool;
+    pool.setBaseThreadCount(2);
+
+    sw::TaskGroup slow, fast;
+    std::atomic<bool> started = false, release = false;
+
+    pool.enqueue(slow, [&] {
+        started = true;
+        while (!release) std::this_thread::yield();
+    });
+
+    // the slow task must be running on a worker, otherwise the waiting thread could pick it up itself
+    while (!started) std::this_thread::yield();
+
+    std::atomic<int> count = 0;
+    for (int i = 0; i < 64; i++) {
+        pool.enqueue(fast, [&] { count++; });
+    }
+
+    pool.wait(fast);
+    CHECK(count == 64);
+    CHECK_FALSE(slow.isDone());
+
+    release = true;
+    pool.wait(slow);
+    CHECK(slow.isDone());
+}
+
+
+TEST_CASE("Exceptions of tasks are rethrown by wait", "[threadpool][exceptions]") {
+    sw::ThreadPool pool;
+    pool.setBaseThreadCount(2);
+
+    std::atomic<int> count = 0;
+    for (int i = 0; i < 8; i++) {
+        pool.enqueue([&, i] {
+            count++;
+            if (i == 3) throw std::runtime_error("task failed");
+        });
+    }
+
+    CHECK_THROWS_AS(pool.wait(), std::runtime_error);
+    CHECK(count == 8);  // the other tasks still run
+
+    // the exception is rethrown only once
+    pool.enqueue([&] { count++; });
+    CHECK_NOTHROW(pool.wait());
+
+    SECTION("within a task group") {
+        sw::TaskGroup group;
+        pool.enqueue(group, [] { throw std::logic_error("group task failed"); });
+        CHECK_THROWS_AS(pool.wait(group), std::logic_error);
+        CHECK_NOTHROW(pool.wait());
+    }
+}
+
+
+TEST_CASE("Only the active workers run tasks", "[threadpool][active]") {
+    sw::ThreadPool pool;
+    pool.setBaseThreadCount(4);
+    pool.setActiveThreadCount(1);
+
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    const auto run_tasks = [&] {
+        threads.clear();
+        for (int i = 0; i < 256; i++) {
+            pool.enqueue([&] {
+                std::lock_guard lock(mutex);
+                threads.insert(std::this_thread::get_id());
+            });
+        } pool.wait();
+    };
+
+    run_tasks();
+    CHECK(threads.size() <= 2);  // the first worker, and the thread which waits
+
+    const auto stats = pool.getWorkerStats();
+    REQUIRE(stats.size() == 4);
+    for (std::size_t i = 1; i < stats.size(); i++) {
+        CHECK(stats[i].tasks_run == 0);
+    }
+
+    // raising the limit again wakes the sleeping workers up
+    pool.setActiveThreadCount(4);
+    std::atomic<int> count = 0;
+    for (int i = 0; i < 256; i++) {
+        pool.enqueue([&] { count++; });
+    }
+
+    pool.wait();
+    CHECK(count == 256);
+}
+
+
+TEST_CASE("A pool without threads runs the tasks inline", "[threadpool][inline]") {
+    sw::ThreadPool pool;
+    CHECK(pool.getThreadCount() == 0);
+
+    int count = 0;
+    std::thread::id thread;
+    pool.enqueue([&] {
+        count++;
+        thread = std::this_thread::get_id();
+        pool.enqueue([&] { count++; });
+    });
+
+    // already done, before waiting
+    CHECK(count == 2);
+    CHECK(thread == std::this_thread::get_id());
+    CHECK_NOTHROW(pool.wait());
+
+    CHECK_THROWS_AS(pool.enqueue([] { throw std::runtime_error("inline task failed"); }), std::runtime_error);
+}